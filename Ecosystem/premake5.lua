@@ -19,7 +19,7 @@ project "Ecosystem"
         "%{IncludeDir.GLFW}",
         "%{IncludeDir.Glad}",
         "%{IncludeDir.glm}",
-        "%{IncludeDir.stb}"      -- stb: headers seulement
+        "%{IncludeDir.stb}"      -- stb_image : cartes d'habitat (world/HabitatMap)
     }
 
     -- Pas besoin de libdirs si tu compiles les vendors dans la workspace
@@ -34,8 +34,8 @@ project "Ecosystem"
     links {
         "GLFW",
         "Glad",
+        "stb",                   -- implementation compilee dans vendor/stb
         "opengl32"               -- Windows OpenGL system lib
-        -- NE PAS lier 'stb' (header-only)
     }
 
     filter "system:windows"
@@ -0,0 +1,693 @@
+#include "Benchmarks.h"
+#include "world/World.h"
+#include "world/Ensemble.h"
+#include "world/ClusterAnalysis.h"
+#include "world/AgingKernel.h"
+#include "core/MemoryStats.h"
+#include "core/Parallel.h"
+#include "core/PerfCounters.h"
+#include "core/MappedStorage.h"
+#include "core/Topology.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <vector>
+
+namespace Ecosystem {
+
+    namespace {
+
+        using Clock = std::chrono::steady_clock;
+
+        double millis(Clock::duration d) {
+            return std::chrono::duration<double, std::milli>(d).count();
+        }
+
+        // Grille carree, populations initiales a la densite de la configuration par defaut.
+        void configure(Config& cfg, const BenchOptions& opt) {
+            const double defaultArea = 20.0 * 15.0;
+            double scale = static_cast<double>(opt.size) * opt.size / defaultArea;
+            cfg.width = opt.size;
+            cfg.height = opt.size;
+            cfg.initial_plants = static_cast<int>(80 * scale);
+            cfg.initial_herbivores = static_cast<int>(30 * scale);
+            cfg.initial_carnivores = static_cast<int>(30 * scale);
+        }
+
+        // Plantes, herbivores, carnivores : sur tout le monde puis dans la region d'interet.
+        using Census = std::array<double, 6>;
+        const char* const kCensusNames[] = {
+            "plantes", "herbivores", "carnivores",
+            "plantes (roi)", "herbivores (roi)", "carnivores (roi)"
+        };
+
+        struct Run {
+            std::vector<Census> series;
+            double ms = 0.0;
+            int aggregateTiles = 0;
+            int tiles = 0;
+        };
+
+        Run simulate(Config& cfg, int turns, const LodOptions& roi, bool hybrid) {
+            World world(cfg);
+            if (hybrid) world.enableLevelOfDetail(roi);
+
+            Run run;
+            run.series.reserve(turns);
+            for (int t = 0; t < turns; ++t) {
+                auto start = Clock::now();
+                world.step();
+                run.ms += millis(Clock::now() - start);
+
+                TurnMetrics m = world.metrics();
+                auto r = world.regionCounts(roi.roiX0, roi.roiY0, roi.roiX1, roi.roiY1);
+                run.series.push_back({ double(m.plants), double(m.herbivores()), double(m.carnivores()),
+                    double(r.plants), double(r.herbivores), double(r.carnivores) });
+            }
+            if (auto* l = world.levelOfDetail()) {
+                run.aggregateTiles = l->aggregateTiles();
+                run.tiles = l->tileCount();
+            }
+            return run;
+        }
+
+        // Ecart absolu moyen sur tous les tours et au dernier tour ; ecart relatif a
+        // l'effectif moyen de la reference, negatif si celui-ci est sous kMinCount.
+        struct SeriesError {
+            static constexpr double kMinCount = 50.0;
+            double mean = 0.0;
+            double last = 0.0;
+            double relative = -1.0;
+        };
+
+        SeriesError seriesError(const Run& a, const Run& ref, std::size_t k) {
+            SeriesError e;
+            std::size_t n = std::min(a.series.size(), ref.series.size());
+            if (n == 0) return e;
+            double refTotal = 0.0;
+            for (std::size_t t = 0; t < n; ++t) {
+                e.last = std::abs(a.series[t][k] - ref.series[t][k]);
+                e.mean += e.last;
+                refTotal += ref.series[t][k];
+            }
+            if (refTotal / n >= SeriesError::kMinCount) e.relative = e.mean / refTotal;
+            e.mean /= n;
+            return e;
+        }
+
+        // Regles ou les trois especes se maintiennent : avec la configuration par
+        // defaut, herbivores ou carnivores disparaissent en quelques dizaines de tours
+        // et l'ecart ne mesure plus rien. Choisies sur 128x128, graines 1 et 2 : au
+        // moins ~3900 plantes, 1200 herbivores et 60 carnivores entre les tours 30 et 200.
+        // Graine fixee : le banc compare a la graine suivante.
+        void configureLevelOfDetail(Config& cfg, const BenchOptions& opt) {
+            configure(cfg, opt);
+            cfg.seed = 1;
+            double scale = static_cast<double>(opt.size) * opt.size / 300.0;
+            cfg.initial_herbivores = static_cast<int>(20 * scale);
+            cfg.initial_carnivores = static_cast<int>(2 * scale);
+            cfg.starvation_limit = 60;
+            cfg.repro_cool_down = 24;
+            cfg.plant_spread_period = 1;
+            cfg.plant_spread_chance_percent = 100;
+        }
+
+        // Simulation hybride contre simulation complete, meme graine. L'ecart entre
+        // deux graines de la simulation complete donne l'echelle du bruit.
+        int benchLevelOfDetail(Config& cfg, const BenchOptions& opt) {
+            configureLevelOfDetail(cfg, opt);
+            LodOptions lod;
+            lod.roiX0 = lod.roiY0 = opt.size * 3 / 8;
+            lod.roiX1 = lod.roiY1 = opt.size * 5 / 8 - 1;
+
+            unsigned seed = cfg.seed;
+            Run full = simulate(cfg, opt.turns, lod, false);
+            Run hybrid = simulate(cfg, opt.turns, lod, true);
+            cfg.seed = seed + 1;
+            Run other = simulate(cfg, opt.turns, lod, false);
+            cfg.seed = seed;
+
+            std::cout << "Banc lod : " << opt.size << "x" << opt.size << ", " << opt.turns << " tours, graine "
+                << seed << ", region d'interet [" << lod.roiX0 << "," << lod.roiX1 << "]^2\n"
+                << std::fixed << std::setprecision(1)
+                << "  complet " << full.ms << " ms | hybride " << hybrid.ms << " ms (x"
+                << std::setprecision(2) << full.ms / std::max(hybrid.ms, 1e-3) << ") | tuiles agregees en fin "
+                << hybrid.aggregateTiles << "/" << hybrid.tiles << "\n\n";
+
+            // Relatif : ecart absolu cumule sur l'effectif cumule de la reference.
+            auto relative = [](double r) {
+                std::ostringstream out;
+                if (r < 0.0) out << "-";
+                else out << std::fixed << std::setprecision(1) << r * 100 << "%";
+                return out.str();
+            };
+            std::cout << "  " << std::left << std::setw(18) << "serie" << std::right
+                << std::setw(10) << "complet" << std::setw(10) << "hybride"
+                << std::setw(12) << "ecart moyen" << std::setw(12) << "ecart final" << std::setw(10) << "relatif"
+                << std::setw(16) << "bruit graines" << std::setw(10) << "relatif" << "\n";
+            for (std::size_t k = 0; k < std::size(kCensusNames); ++k) {
+                SeriesError e = seriesError(hybrid, full, k);
+                SeriesError noise = seriesError(other, full, k);
+                std::cout << "  " << std::left << std::setw(18) << kCensusNames[k] << std::right
+                    << std::setprecision(0)
+                    << std::setw(10) << (full.series.empty() ? 0.0 : full.series.back()[k])
+                    << std::setw(10) << (hybrid.series.empty() ? 0.0 : hybrid.series.back()[k])
+                    << std::setprecision(1)
+                    << std::setw(12) << e.mean << std::setw(12) << e.last << std::setw(10) << relative(e.relative)
+                    << std::setw(16) << noise.mean << std::setw(10) << relative(noise.relative) << "\n";
+            }
+            std::cout << "  ecarts en individus ; relatif si la reference compte en moyenne au moins "
+                << std::setprecision(0) << SeriesError::kMinCount << " individus\n";
+            return 0;
+        }
+
+        // Branches "et si" : apres opt.turns tours de rechauffe, chaque branche part d'un
+        // fork avec sa propre graine et avance opt.turns / 4 tours. Compare au cout de
+        // rejouer la rechauffe pour chaque branche.
+        int benchFork(Config& cfg, const BenchOptions& opt) {
+            configure(cfg, opt);
+            const int branches = 4;
+            const int ahead = std::max(1, opt.turns / 4);
+
+            World parent(cfg);
+            auto start = Clock::now();
+            for (int t = 0; t < opt.turns; ++t) parent.step();
+            double warmup = millis(Clock::now() - start);
+
+            std::vector<Config> configs(branches, cfg);
+            std::vector<std::unique_ptr<World>> forks;
+            start = Clock::now();
+            for (int b = 0; b < branches; ++b) {
+                configs[b].seed = cfg.seed + 1 + b;
+                forks.push_back(parent.fork(configs[b]));
+            }
+            double forking = millis(Clock::now() - start);
+            auto pages = parent.sharedPages();
+
+            std::cout << "Banc fork : " << opt.size << "x" << opt.size << ", rechauffe " << opt.turns
+                << " tours, " << branches << " branches de " << ahead << " tours\n"
+                << std::fixed << std::setprecision(2)
+                << "  rechauffe " << warmup << " ms | " << branches << " forks " << forking
+                << " ms | pages partagees " << pages.first << "/" << pages.second << "\n";
+
+            double stepping = 0.0;
+            for (int b = 0; b < branches; ++b) {
+                start = Clock::now();
+                forks[b]->step();
+                double first = millis(Clock::now() - start);
+                // Apres un tour : seules les pages ecrites par la branche sont copiees.
+                auto firstPages = forks[b]->sharedPages();
+                for (int t = 1; t < ahead; ++t) forks[b]->step();
+                stepping += millis(Clock::now() - start);
+                TurnMetrics m = forks[b]->metrics();
+                std::cout << "  branche " << b << " (graine " << configs[b].seed << ") : premier tour " << first
+                    << " ms, pages partagees " << firstPages.first << "/" << firstPages.second
+                    << " | herbivores " << m.herbivores() << " carnivores " << m.carnivores() << "\n";
+            }
+            std::cout << "  total forks " << forking + stepping << " ms | en rejouant la rechauffe "
+                << branches * warmup + stepping << " ms\n";
+            return 0;
+        }
+
+        // Petits mondes (dimensions de la configuration, 20x15 par defaut) : un World par
+        // thread contre des ensembles de Ensemble::kLanes voies. opt.size donne le nombre
+        // de mondes ; chaque monde a sa graine. Les hash finaux doivent concorder.
+        int benchEnsemble(Config& cfg, const BenchOptions& opt) {
+            const int worlds = std::max(1, opt.size);
+            std::vector<Config> configs(worlds, cfg);
+            for (int w = 0; w < worlds; ++w) configs[w].seed = cfg.seed + w;
+
+            std::vector<std::uint64_t> reference(worlds);
+            auto start = Clock::now();
+            parallelFor(worlds, 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t w = begin; w < end; ++w) {
+                    World world(configs[w]);
+                    for (int t = 0; t < opt.turns; ++t) world.step();
+                    reference[w] = world.stateHash();
+                }
+            });
+            double threaded = millis(Clock::now() - start);
+
+            const int groups = (worlds + Ensemble::kLanes - 1) / Ensemble::kLanes;
+            std::vector<std::uint64_t> lanes(worlds);
+            auto runGroup = [&](int g) {
+                auto first = configs.begin() + g * Ensemble::kLanes;
+                Ensemble ensemble(std::vector<Config>(first, first + std::min(Ensemble::kLanes, worlds - g * Ensemble::kLanes)));
+                for (int t = 0; t < opt.turns; ++t) ensemble.step();
+                for (int l = 0; l < ensemble.lanes(); ++l) lanes[g * Ensemble::kLanes + l] = ensemble.stateHash(l);
+            };
+
+            start = Clock::now();
+            for (int g = 0; g < groups; ++g) runGroup(g);
+            double single = millis(Clock::now() - start);
+
+            start = Clock::now();
+            parallelFor(groups, 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t g = begin; g < end; ++g) runGroup(static_cast<int>(g));
+            });
+            double parallel = millis(Clock::now() - start);
+
+            int mismatches = 0;
+            for (int w = 0; w < worlds; ++w) mismatches += lanes[w] != reference[w] ? 1 : 0;
+
+            std::cout << "Banc ensemble : " << worlds << " mondes " << cfg.width << "x" << cfg.height << ", "
+                << opt.turns << " tours, " << workerCount() << " threads\n"
+                << std::fixed << std::setprecision(1)
+                << "  un World par thread      " << threaded << " ms\n"
+                << "  ensembles, un thread     " << single << " ms (x" << std::setprecision(2)
+                << threaded / std::max(single, 1e-3) << ")\n" << std::setprecision(1)
+                << "  ensembles, " << workerCount() << " threads " << parallel << " ms (x" << std::setprecision(2)
+                << threaded / std::max(parallel, 1e-3) << ")\n"
+                << "  hash finaux differents du World : " << mismatches << "/" << worlds << "\n";
+            return mismatches == 0 ? 0 : 1;
+        }
+
+        // Noyaux de vieillissement d'Ensemble sur taille x taille cellules de 16 voies aux
+        // compteurs tires au hasard : memes compteurs et memes masques pour chaque noyau
+        // disponible, puis debit sur opt.turns passes (4 colonnes lues et ecrites).
+        int benchAging(Config& cfg, const BenchOptions& opt) {
+            const std::size_t cells = static_cast<std::size_t>(opt.size) * opt.size;
+            const std::size_t bytes = cells * AgingColumns::kLanes;
+            const int passes = std::max(1, opt.turns);
+
+            std::mt19937 rng(cfg.seed);
+            std::uniform_int_distribution<int> counter(0, 12);
+            std::array<std::vector<std::uint8_t>, 4> initial;
+            for (auto& column : initial) {
+                column.resize(bytes);
+                for (auto& v : column) v = static_cast<std::uint8_t>(counter(rng));
+            }
+            std::array<std::uint8_t, AgingColumns::kLanes> limit{};
+            for (auto& v : limit) v = static_cast<std::uint8_t>(4 + counter(rng));
+
+            std::cout << "Banc aging : " << cells << " cellules x " << AgingColumns::kLanes << " voies, "
+                << passes << " passes\n" << std::fixed << std::setprecision(2);
+            std::array<std::vector<std::uint8_t>, 4> reference;
+            std::vector<std::uint16_t> referenceMask;
+            int failed = 0;
+            for (AgingKernel k : { AgingKernel::Scalar, AgingKernel::Avx2 }) {
+                if (!agingKernelAvailable(k)) {
+                    std::cout << "  " << std::left << std::setw(9) << agingKernelName(k) << std::right
+                        << "indisponible sur ce processeur\n";
+                    continue;
+                }
+                auto columns = initial;
+                std::vector<std::uint16_t> starving(cells);
+                AgingColumns c{ columns[0].data(), columns[1].data(), columns[2].data(), columns[3].data(), limit.data() };
+
+                ageCells(k, c, cells, starving.data());
+                if (k == AgingKernel::Scalar) {
+                    reference = columns;
+                    referenceMask = starving;
+                }
+                else if (columns != reference || starving != referenceMask) {
+                    std::cout << "  " << agingKernelName(k) << " : compteurs ou masques differents du scalaire\n";
+                    failed = 1;
+                }
+
+                auto start = Clock::now();
+                for (int p = 0; p < passes; ++p) ageCells(k, c, cells, starving.data());
+                double ms = millis(Clock::now() - start) / passes;
+                double gbs = 2.0 * 4 * bytes / (ms * 1e6);
+                std::cout << "  " << std::left << std::setw(9) << agingKernelName(k) << std::right
+                    << ms << " ms/passe | " << gbs << " Go/s\n";
+            }
+            return failed;
+        }
+
+        // Flux de sortie qui jette tout : le rendu est execute sans rien afficher.
+        struct NullBuffer : std::streambuf {
+            int overflow(int c) override { return c; }
+        };
+
+        // Allocations par tour une fois le regime etabli (apres opt.turns / 4 tours) :
+        // un tour complet avec statistiques, rendu et apercu. Les donnees du tour vivent
+        // dans l'arene du monde, la ligne de statistiques dans un tampon local ; restent les entites nees pendant le tour (animaux,
+        // plantes, strategies) et les tables qui suivent le pic de population.
+        int benchFrame(Config& cfg, const BenchOptions& opt) {
+            configure(cfg, opt);
+            const int warmup = std::max(1, opt.turns / 4);
+            World world(cfg);
+            World::View view;
+            view.zoom = std::max(1, opt.size / view.columns);
+
+            NullBuffer sink;
+            auto turn = [&](int t) {
+                world.step();
+                std::streambuf* out = std::cout.rdbuf(&sink);
+                char line[World::kStatsLineMax];
+                std::cout.write(line, static_cast<std::streamsize>(world.writeStatsLine(t, line, sizeof(line)))) << "\n";
+                world.print();
+                world.printView(view);
+                std::cout.rdbuf(out);
+            };
+
+            for (int t = 0; t < warmup; ++t) turn(t);
+            auto before = MemoryStats::I().snapshot();
+            auto blocks = world.frameArena().blockAllocations();
+            auto start = Clock::now();
+            for (int t = warmup; t < opt.turns; ++t) turn(t);
+            double ms = millis(Clock::now() - start);
+            auto after = MemoryStats::I().snapshot();
+
+            const int measured = std::max(1, opt.turns - warmup);
+            auto perTurn = [&](MemCategory c) {
+                auto k = static_cast<std::size_t>(c);
+                return static_cast<double>(after[k].allocations - before[k].allocations) / measured;
+            };
+            double transient = perTurn(MemCategory::Scratch) + perTurn(MemCategory::Output);
+
+            std::cout << "Banc frame : " << opt.size << "x" << opt.size << ", " << measured << " tours mesures apres "
+                << warmup << " de rechauffe\n" << std::fixed << std::setprecision(2)
+                << "  " << ms / measured << " ms/tour | arene " << world.frameArena().capacity() << " octets, pic "
+                << world.frameArena().peak() << " | blocs d'arene alloues pendant la mesure "
+                << world.frameArena().blockAllocations() - blocks << "\n"
+                << "  allocations par tour :";
+            for (std::size_t k = 0; k < MemoryStats::kCategories; ++k) {
+                std::cout << " " << MemoryStats::name(static_cast<MemCategory>(k)) << "=" << perTurn(static_cast<MemCategory>(k));
+            }
+            std::cout << "\n  transitoires (scratch + output) : " << transient << " par tour\n";
+            return transient == 0.0 ? 0 : 1;
+        }
+
+        // Memes tours sous chaque politique de pages : tas, pages enormes, puis pages
+        // enormes placees par noeud si la machine en a plusieurs. Les hash doivent concorder.
+        int benchPages(Config& cfg, const BenchOptions& opt) {
+            configure(cfg, opt);
+            struct Policy { const char* name; bool huge; bool numa; };
+            std::vector<Policy> policies = { { "tas", false, false }, { "pages enormes", true, false } };
+            if (Topology::I().nodes() > 1) policies.push_back({ "pages enormes + NUMA", true, true });
+
+            std::cout << "Banc pages : " << opt.size << "x" << opt.size << ", " << opt.turns << " tours, "
+                << Topology::I().nodes() << " noeud(s) NUMA\n" << std::fixed << std::setprecision(2);
+            std::uint64_t reference = 0;
+            int mismatches = 0;
+            for (auto const& p : policies) {
+                Config run = cfg;
+                run.huge_pages = p.huge;
+                run.numa_placement = p.numa;
+                auto start = Clock::now();
+                World world(run);
+                double setup = millis(Clock::now() - start);
+                start = Clock::now();
+                for (int t = 0; t < opt.turns; ++t) world.step();
+                double ms = millis(Clock::now() - start);
+                std::int64_t huge = hugePageBytes();
+
+                if (&p == &policies.front()) reference = world.stateHash();
+                mismatches += world.stateHash() != reference ? 1 : 0;
+                std::cout << "  " << std::left << std::setw(22) << p.name << std::right
+                    << " creation " << setup << " ms | " << ms / std::max(1, opt.turns) << " ms/tour | pages enormes ";
+                if (huge >= 0) std::cout << huge / (1 << 20) << " Mo\n";
+                else std::cout << "inconnu\n";
+            }
+            std::cout << "  hash finaux differents : " << mismatches << "\n";
+            return mismatches == 0 ? 0 : 1;
+        }
+
+        // Memes tours dans chaque disposition de la grille. Padded doit redonner les
+        // etats de RowMajor ; Tiled suit sa propre trajectoire.
+        int benchLayout(Config& cfg, const BenchOptions& opt) {
+            configure(cfg, opt);
+            struct Variant { const char* name; GridLayout layout; };
+            const Variant variants[] = {
+                { "ligne", GridLayout::RowMajor }, { "tuiles", GridLayout::Tiled }, { "bordure", GridLayout::Padded }
+            };
+
+            std::cout << "Banc layout : " << opt.size << "x" << opt.size << ", " << opt.turns << " tours\n"
+                << std::fixed << std::setprecision(2);
+            std::uint64_t rowMajor = 0;
+            bool same = true;
+            for (auto const& v : variants) {
+                World world(cfg, v.layout);
+                auto start = Clock::now();
+                for (int t = 0; t < opt.turns; ++t) world.step();
+                double ms = millis(Clock::now() - start);
+                if (v.layout == GridLayout::RowMajor) rowMajor = world.stateHash();
+                if (v.layout == GridLayout::Padded) same = world.stateHash() == rowMajor;
+                std::cout << "  " << std::left << std::setw(8) << v.name << std::right
+                    << ms / std::max(1, opt.turns) << " ms/tour\n";
+            }
+            std::cout << "  bordure identique a ligne : " << (same ? "oui" : "non") << "\n";
+            return same ? 0 : 1;
+        }
+
+        // Memes tours en un appel de step() et decoupes sous un budget de 2 ms par
+        // appel : plus longue attente de l'appelant dans chaque cas, memes hash.
+        int benchSlice(Config& cfg, const BenchOptions& opt) {
+            configure(cfg, opt);
+            const auto budget = std::chrono::microseconds(2000);
+
+            std::cout << "Banc slice : " << opt.size << "x" << opt.size << ", " << opt.turns << " tours, budget "
+                << budget.count() / 1000.0 << " ms\n" << std::fixed << std::setprecision(2);
+            std::uint64_t whole = 0;
+            for (bool sliced : { false, true }) {
+                World world(cfg);
+                double longest = 0.0;
+                long long calls = 0;
+                auto start = Clock::now();
+                for (int t = 0; t < opt.turns; ++t) {
+                    bool done = false;
+                    while (!done) {
+                        auto begin = Clock::now();
+                        if (sliced) done = world.stepFor(budget);
+                        else { world.step(); done = true; }
+                        longest = std::max(longest, millis(Clock::now() - begin));
+                        calls++;
+                    }
+                }
+                double ms = millis(Clock::now() - start);
+                if (!sliced) whole = world.stateHash();
+                std::cout << "  " << std::left << std::setw(8) << (sliced ? "decoupe" : "entier") << std::right
+                    << ms / std::max(1, opt.turns) << " ms/tour | " << calls << " appels | plus long "
+                    << longest << " ms\n";
+                if (sliced && world.stateHash() != whole) {
+                    std::cout << "  hash differents\n";
+                    return 1;
+                }
+            }
+            return 0;
+        }
+
+        // Carte synthetique de taille x taille (PGM : degrade de densite, murs perces)
+        // ecrite dans le repertoire temporaire, puis creation du monde depuis la carte
+        // et au hasard avec autant d'individus.
+        int benchHabitat(Config& cfg, const BenchOptions& opt) {
+            configure(cfg, opt);
+            auto path = std::filesystem::temp_directory_path() / "ecosystem_habitat.pgm";
+            {
+                std::ofstream out(path, std::ios::binary);
+                out << "P5\n" << opt.size << " " << opt.size << "\n255\n";
+                std::vector<char> row(static_cast<std::size_t>(opt.size));
+                for (int y = 0; y < opt.size; ++y) {
+                    for (int x = 0; x < opt.size; ++x) {
+                        bool wall = x % 97 < 3 && y % 16 != 0;
+                        row[x] = static_cast<char>(wall ? 0 : 1 + x * 254 / opt.size);
+                    }
+                    out.write(row.data(), static_cast<std::streamsize>(row.size()));
+                }
+                if (!out) {
+                    std::cerr << "  Ecriture impossible : " << path.string() << "\n";
+                    return 1;
+                }
+            }
+
+            std::cout << "Banc habitat : " << opt.size << "x" << opt.size << "\n" << std::fixed << std::setprecision(2);
+            Config fromMap = cfg;
+            fromMap.habitat_map = path.string();
+            auto start = Clock::now();
+            auto mapped = std::make_unique<World>(fromMap);
+            double mapMs = millis(Clock::now() - start);
+            TurnMetrics m = mapped->metrics();
+            mapped.reset();
+            std::filesystem::remove(path);
+
+            cfg.initial_plants = m.plants;
+            cfg.initial_herbivores = m.herbivores();
+            cfg.initial_carnivores = m.carnivores();
+            start = Clock::now();
+            auto random = std::make_unique<World>(cfg);
+            double randomMs = millis(Clock::now() - start);
+
+            std::cout << "  carte   " << mapMs << " ms | plantes " << m.plants << " herbivores " << m.herbivores()
+                << " carnivores " << m.carnivores() << "\n";
+            std::cout << "  hasard  " << randomMs << " ms (memes effectifs de base)\n";
+            return 0;
+        }
+
+        // Analyse des groupes apres chaque tour, contre le tour lui-meme.
+        int benchClusters(Config& cfg, const BenchOptions& opt) {
+            configure(cfg, opt);
+            World world(cfg);
+            ClusterAnalysis clusters;
+            ClusterReport report{};
+            double stepMs = 0.0, analysisMs = 0.0;
+            for (int t = 0; t < opt.turns; ++t) {
+                auto start = Clock::now();
+                world.step();
+                stepMs += millis(Clock::now() - start);
+                start = Clock::now();
+                report = clusters.analyze(world);
+                analysisMs += millis(Clock::now() - start);
+            }
+
+            int turns = std::max(1, opt.turns);
+            std::cout << "Banc clusters : " << opt.size << "x" << opt.size << ", " << opt.turns << " tours, "
+                << workerCount() << " thread(s)\n" << std::fixed << std::setprecision(2)
+                << "  tour " << stepMs / turns << " ms | analyse " << analysisMs / turns << " ms\n"
+                << "  " << ClusterAnalysis::summary(report) << "\n";
+            return 0;
+        }
+
+        // Empreinte des identites : poignee, mere et pere de chaque animal, par cellule.
+        std::uint64_t identityDigest(const World& world) {
+            std::uint64_t h = 1469598103934665603ull;
+            auto mix = [&](std::uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+            auto mixHandle = [&](World::AnimalHandle a) {
+                mix(static_cast<std::uint32_t>(a.slot));
+                mix(a.generation);
+            };
+            for (int y = world.rowBegin(); y < world.rowEnd(); ++y) {
+                for (int x = 0; x < world.cfg().width; ++x) {
+                    World::AnimalHandle a = world.handleAt(x, y);
+                    if (!a.valid()) continue;
+                    World::AnimalRecord r = world.record(a);
+                    mix(static_cast<std::uint64_t>(y) * world.cfg().width + x);
+                    mixHandle(a);
+                    mixHandle(r.mother);
+                    mixHandle(r.father);
+                }
+            }
+            return h;
+        }
+
+        // Memes tours systeme par systeme puis en front d'onde (Config::fused_step),
+        // dans les trois dispositions : temps par tour, hash et identites compares a
+        // chaque tour. Le gain attendu est sur les passes memoire (nourrissage,
+        // reproduction) : les decisions de deplacement sont dominees par le calcul et
+        // pesent pareil dans les deux cas. Temps par section (PerfCounters) et defauts
+        // de cache s'ils sont lisibles.
+        int benchFused(Config& cfg, const BenchOptions& opt) {
+            configure(cfg, opt);
+            struct Variant { const char* name; GridLayout layout; };
+            const Variant variants[] = {
+                { "ligne", GridLayout::RowMajor }, { "tuiles", GridLayout::Tiled }, { "bordure", GridLayout::Padded }
+            };
+            const PerfScope scopes[] = { PerfScope::Move, PerfScope::Feed, PerfScope::Reproduce };
+
+            PerfCounters& perf = PerfCounters::I();
+            perf.enable();
+            const bool misses = perf.hasEvent(PerfEvent::CacheMisses);
+            auto snapshot = [&]() {
+                std::array<PerfCounters::Sample, std::size(scopes)> s;
+                for (std::size_t k = 0; k < std::size(scopes); ++k) s[k] = perf.total(scopes[k]);
+                return s;
+            };
+
+            std::cout << "Banc fused : " << opt.size << "x" << opt.size << ", " << opt.turns << " tours\n"
+                << "  ms/tour (dont deplacements | nourrissage + reproduction)"
+                << (misses ? ", defauts de cache/tour de nourrissage + reproduction" : "") << "\n"
+                << std::fixed << std::setprecision(2);
+            const bool fused = cfg.fused_step;
+            const int turns = std::max(1, opt.turns);
+            int failed = 0;
+            for (auto const& v : variants) {
+                std::vector<std::uint64_t> hashes;
+                std::vector<std::uint64_t> identities;
+                std::cout << "  " << v.name << "\n";
+                for (int pass = 0; pass < 2; ++pass) {
+                    cfg.fused_step = pass == 1;
+                    World world(cfg, v.layout);
+                    auto before = snapshot();
+                    double ms = 0.0;
+                    for (int t = 0; t < opt.turns; ++t) {
+                        auto start = Clock::now();
+                        world.step();
+                        ms += millis(Clock::now() - start);
+                        if (pass == 0) {
+                            hashes.push_back(world.stateHash());
+                            identities.push_back(identityDigest(world));
+                        }
+                        else if (world.stateHash() != hashes[t]) {
+                            std::cout << "    hash different au tour " << t + 1 << "\n";
+                            failed = 1;
+                            break;
+                        }
+                        else if (identityDigest(world) != identities[t]) {
+                            std::cout << "    identites ou filiations differentes au tour " << t + 1 << "\n";
+                            failed = 1;
+                            break;
+                        }
+                    }
+                    auto after = snapshot();
+                    auto sectionMs = [&](std::size_t k) { return (after[k].seconds - before[k].seconds) * 1000.0 / turns; };
+                    auto sectionMisses = [&](std::size_t k) {
+                        std::size_t e = static_cast<std::size_t>(PerfEvent::CacheMisses);
+                        return static_cast<double>(after[k].events[e] - before[k].events[e]) / turns;
+                    };
+                    std::cout << "    " << std::left << std::setw(12) << (pass == 1 ? "fusionne" : "systemes") << std::right
+                        << std::setw(10) << ms / turns << " (" << sectionMs(0) << " | " << sectionMs(1) + sectionMs(2) << ")";
+                    if (misses) std::cout << std::setprecision(0) << " " << sectionMisses(1) + sectionMisses(2) << std::setprecision(2);
+                    std::cout << "\n";
+                }
+            }
+            cfg.fused_step = fused;
+            std::cout << "  fusionne identique (hash, identites, filiations) : " << (failed ? "non" : "oui") << "\n";
+            return failed;
+        }
+
+        struct Benchmark {
+            const char* name;
+            const char* description;
+            int (*run)(Config&, const BenchOptions&);
+        };
+
+        const Benchmark kBenchmarks[] = {
+            { "lod", "simulation hybride (champ moyen hors region d'interet) contre simulation complete",
+              benchLevelOfDetail },
+            { "fork", "branches copiees sur ecriture depuis un monde rechauffe, contre rejouer la rechauffe",
+              benchFork },
+            { "ensemble", "petits mondes par voies entrelacees contre un World par thread (taille = nombre de mondes)",
+              benchEnsemble },
+            { "aging", "noyaux de vieillissement des compteurs par voies (scalaire, AVX2 si disponible) : memes resultats, debit",
+              benchAging },
+            { "frame", "allocations par tour en regime etabli (tour, statistiques, rendu) ; echoue s'il en reste de transitoires",
+              benchFrame },
+            { "pages", "tas contre pages enormes (et placement NUMA s'il y a plusieurs noeuds), memes tours",
+              benchPages },
+            { "layout", "ordre ligne, tuiles et bordure de cellules vides ; la bordure doit redonner l'ordre ligne",
+              benchLayout },
+            { "slice", "tours decoupes sous un budget de temps contre step() entier : attente maximale, memes etats",
+              benchSlice },
+            { "habitat", "creation d'un monde depuis une carte d'habitat (image PGM generee) contre peuplement au hasard",
+              benchHabitat },
+            { "clusters", "composantes connexes des trois couches (union-find par bandes) a chaque tour, contre le tour",
+              benchClusters },
+            { "fused", "deplacements, nourrissage et reproduction en front d'onde de bandes contre systeme par systeme ; memes hash et identites",
+              benchFused },
+        };
+    }
+
+    std::string benchmarkList() {
+        std::ostringstream out;
+        for (auto const& b : kBenchmarks) out << "  " << b.name << " : " << b.description << "\n";
+        return out.str();
+    }
+
+    int runBenchmark(Config& cfg, const BenchOptions& opt) {
+        for (auto const& b : kBenchmarks) {
+            if (opt.name == b.name) return b.run(cfg, opt);
+        }
+        std::cerr << "  Banc inconnu : " << opt.name << "\n" << benchmarkList();
+        return 1;
+    }
+}
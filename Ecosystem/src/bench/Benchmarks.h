@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include "core/Config.h"
+
+namespace Ecosystem {
+
+    // Bancs d'essai lances par `Ecosystem --bench <nom> [taille] [tours]`. Chacun
+    // reconfigure Config (grille carree de taille cellules, populations initiales a la
+    // densite par defaut) et affiche ses mesures ; renvoie le code de sortie.
+    struct BenchOptions {
+        std::string name;
+        int size = 256;
+        int turns = 200;
+    };
+
+    int runBenchmark(Config& cfg, const BenchOptions& opt);
+    // Noms et descriptions des bancs, une ligne chacun.
+    std::string benchmarkList();
+}
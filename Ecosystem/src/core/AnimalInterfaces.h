@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
 #include "EntityBase.h"
 
 namespace Ecosystem {
@@ -17,19 +19,38 @@ namespace Ecosystem {
 		Female
 	};
 
+	// Echeances en tours absolus plutot que compteurs decrementes a chaque tour :
+	// les compteurs du tour t s'en deduisent. Le monde programme un reveil par
+	// echeance (voir TimerWheel.h) et remet a 0 celles qui sont passees.
+	struct AnimalTimers {
+		int hungryAt = 0;     // premier tour sans satiete
+		int cooldownEnd = 0;  // 0 : peut se reproduire
+		int adultAt = 0;      // 0 : adulte
+		std::int32_t slot = -1; // emplacement dans la table des reveils du monde
+
+		int satiety(int t) const { return std::max(0, hungryAt - t); }
+		int hunger(int t) const { return std::max(0, t - hungryAt); }
+		int cooldown(int t) const { return std::max(0, cooldownEnd - t); }
+		int babyTurns(int t) const { return std::max(0, adultAt - t); }
+		// Bebe jusqu'au traitement de son reveil d'adulte.
+		bool baby() const { return adultAt != 0; }
+
+		static AnimalTimers fromCounters(int t, int satiety, int hunger, int cooldown, int baby) {
+			AnimalTimers r;
+			r.hungryAt = t + satiety - hunger;
+			r.cooldownEnd = cooldown > 0 ? t + cooldown : 0;
+			r.adultAt = baby > 0 ? t + baby : 0;
+			return r;
+		}
+	};
+
 	struct IAnimal : public IEntity {
 		virtual AnimalKind kind() const = 0;
 		virtual Gender gender() const = 0;
-		virtual void on_step_begin() = 0;
-		virtual int& baby_turns_ref() = 0;
-
-		virtual bool is_Hungry() const = 0;
-		virtual int& hungery_ref() = 0;
 
-		virtual int& satiety_ref() = 0;
-		virtual int& repro_cooldown_ref() = 0;
+		virtual AnimalTimers& timers() = 0;
+		virtual const AnimalTimers& timers() const = 0;
 
-		
 		virtual class IMovementStrategy& movement() = 0;
 		virtual class IFeedingStrategy& feeding() = 0;
 	};
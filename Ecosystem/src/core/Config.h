@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <random>
+#include <string>
 
 namespace Ecosystem {
     class Config {
@@ -29,6 +30,31 @@ namespace Ecosystem {
 
         int baby_stay_turns = 3;
 
+        // Recalcule le hash d'etat a chaque tour et signale toute divergence.
+        bool verify_state_hash = false;
+
+        // Deplacements, nourrissage et reproduction avances ensemble bande de lignes
+        // par bande de lignes (voir World::sysFused) : meme etat, memes identites que
+        // systeme par systeme. Pas une option de vitesse : seuls nourrissage et
+        // reproduction y gagnent (voir --bench fused), les decisions de deplacement,
+        // l'essentiel du tour, coutent pareil.
+        bool fused_step = false;
+
+        // Repertoire local ou projeter la grille et les tables par cellule ;
+        // vide = en memoire.
+        std::string mapped_storage_dir;
+
+        // Grille et tables par cellule en memoire anonyme sur pages enormes :
+        // reservees (hugetlbfs) si le systeme en a, transparentes sinon.
+        bool huge_pages = false;
+        // Chaque bande de lignes est placee sur le noeud NUMA de ses lignes (premier
+        // acces par un thread epingle) et chaque domaine epingle sur le noeud de sa bande.
+        bool numa_placement = false;
+
+        // Image de depart (voir HabitatMap) a la place du peuplement au hasard ;
+        // initial_* ne servent plus. Vide = peuplement au hasard.
+        std::string habitat_map;
+
         unsigned seed;
 
     private:
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+
+namespace Ecosystem {
+
+    inline std::uint64_t splitmix64(std::uint64_t z) {
+        z += 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Flux de tirages de la simulation. Chaque tirage est une fonction pure de
+    // (graine, tour, flux, cellule) : le resultat ne depend pas de l'ordre de
+    // parcours, ce qui permet de decouper la grille sans changer la simulation.
+    enum class RandomStream : std::uint64_t {
+        Move = 1,
+        BirthGender,
+        SpreadDirection,
+        SpreadChance,
+        LevelOfDetail,
+        HabitatPlant,
+        HabitatAnimal,
+        HabitatGender
+    };
+
+    // Cle commune a tous les tirages d'un (graine, tour).
+    inline std::uint64_t counterKey(std::uint64_t seed, std::uint64_t turn) {
+        return splitmix64(seed ^ splitmix64(turn));
+    }
+
+    inline std::uint32_t counterRandomKeyed(std::uint64_t key, RandomStream stream, std::uint64_t cell) {
+        return static_cast<std::uint32_t>(
+            splitmix64(key ^ (static_cast<std::uint64_t>(stream) << 56) ^ cell) >> 32);
+    }
+
+    inline std::uint32_t counterRandom(std::uint64_t seed, std::uint64_t turn,
+        RandomStream stream, std::uint64_t cell) {
+        return counterRandomKeyed(counterKey(seed, turn), stream, cell);
+    }
+
+    // Entier uniforme dans [0, n) par multiplication (sans modulo).
+    inline int counterRandomInt(std::uint64_t seed, std::uint64_t turn,
+        RandomStream stream, std::uint64_t cell, int n) {
+        return static_cast<int>((static_cast<std::uint64_t>(counterRandom(seed, turn, stream, cell)) * n) >> 32);
+    }
+
+    inline int counterRandomIntKeyed(std::uint64_t key, RandomStream stream, std::uint64_t cell, int n) {
+        return static_cast<int>((static_cast<std::uint64_t>(counterRandomKeyed(key, stream, cell)) * n) >> 32);
+    }
+}
@@ -0,0 +1,66 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <new>
+
+namespace Ecosystem {
+
+    static constexpr std::size_t kBlockAlign = alignof(std::max_align_t);
+
+    FrameArena::FrameArena(std::size_t initialBytes) {
+        addBlock(initialBytes);
+    }
+
+    FrameArena::~FrameArena() {
+        freeBlocks();
+    }
+
+    std::size_t FrameArena::capacity() const {
+        std::size_t n = 0;
+        for (auto const& b : m_blocks) n += b.size;
+        return n;
+    }
+
+    void FrameArena::addBlock(std::size_t bytes) {
+        bytes = (bytes + kBlockAlign - 1) / kBlockAlign * kBlockAlign;
+        auto* data = static_cast<std::byte*>(::operator new(bytes, std::align_val_t(kBlockAlign)));
+        MemoryStats::I().onAlloc(MemCategory::Scratch, bytes);
+        m_blocks.push_back({ data, bytes });
+        m_blockAllocations++;
+    }
+
+    void FrameArena::freeBlocks() {
+        for (auto const& b : m_blocks) {
+            MemoryStats::I().onFree(MemCategory::Scratch, b.size);
+            ::operator delete(b.data, b.size, std::align_val_t(kBlockAlign));
+        }
+        m_blocks.clear();
+    }
+
+    void* FrameArena::do_allocate(std::size_t bytes, std::size_t align) {
+        for (;;) {
+            Block& b = m_blocks[m_current];
+            std::size_t at = (m_offset + align - 1) / align * align;
+            if (at + bytes <= b.size) {
+                m_offset = at + bytes;
+                m_used += bytes;
+                return b.data + at;
+            }
+            if (m_current + 1 == m_blocks.size()) addBlock(std::max(bytes + align, m_blocks.back().size * 2));
+            m_current++;
+            m_offset = 0;
+        }
+    }
+
+    void FrameArena::reset() {
+        m_peak = std::max(m_peak, m_used);
+        if (m_blocks.size() > 1) {
+            // Un quart de marge pour l'alignement et les tours un peu plus gros.
+            std::size_t size = std::max(m_blocks.front().size, m_peak + m_peak / 4);
+            freeBlocks();
+            addBlock(size);
+        }
+        m_current = 0;
+        m_offset = 0;
+        m_used = 0;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "MemoryStats.h"
+
+namespace Ecosystem {
+
+    // Arene monotone des donnees d'un tour. Allouer avance un pointeur dans des blocs
+    // conserves, liberer ne fait rien, reset() rembobine tout d'un coup. Un tour qui
+    // deborde du premier bloc en ouvre d'autres ; au reset ils sont fondus en un seul
+    // bloc assez grand pour ce tour. Une fois le pic atteint, plus rien n'est demande
+    // au tas. Les blocs sont comptes dans MemCategory::Scratch.
+    class FrameArena : public std::pmr::memory_resource {
+    public:
+        explicit FrameArena(std::size_t initialBytes = std::size_t(64) << 10);
+        ~FrameArena() override;
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // Tout ce qui a ete alloue depuis le dernier reset devient invalide.
+        void reset();
+
+        std::size_t capacity() const;
+        std::size_t used() const { return m_used; }
+        // Plus gros tour depuis la creation, en octets.
+        std::size_t peak() const { return m_peak; }
+        // Blocs demandes au tas depuis la creation.
+        std::int64_t blockAllocations() const { return m_blockAllocations; }
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t align) override;
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override { return this == &o; }
+
+    private:
+        struct Block {
+            std::byte* data;
+            std::size_t size;
+        };
+
+        std::vector<Block, TrackingAllocator<Block, MemCategory::Scratch>> m_blocks;
+        std::size_t m_current = 0;
+        std::size_t m_offset = 0;
+        std::size_t m_used = 0;
+        std::size_t m_peak = 0;
+        std::int64_t m_blockAllocations = 0;
+
+        void addBlock(std::size_t bytes);
+        void freeBlocks();
+    };
+
+    // Conteneurs des donnees d'un tour, construits sur une FrameArena.
+    template <class T>
+    using FrameVector = std::pmr::vector<T>;
+    using FrameString = std::pmr::string;
+
+    // Ramene un conteneur de l'arene a une capacite nulle, avant FrameArena::reset.
+    template <class C>
+    void releaseFrame(C& c) {
+        C(c.get_allocator()).swap(c);
+    }
+}
@@ -0,0 +1,192 @@
+#include "MappedStorage.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define ECOSYSTEM_HAS_MMAP 1
+#endif
+
+namespace Ecosystem {
+
+#if defined(ECOSYSTEM_HAS_MMAP)
+
+    static std::size_t pageSize() {
+        static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    void* mapTemporaryFile(const std::string& directory, std::size_t bytes) {
+        if (bytes == 0) bytes = 1;
+        std::string pattern = (directory.empty() ? std::string(".") : directory) + "/ecosystem-grid-XXXXXX";
+        std::vector<char> path(pattern.begin(), pattern.end());
+        path.push_back('\0');
+
+        int fd = ::mkstemp(path.data());
+        if (fd < 0) return nullptr;
+        ::unlink(path.data());
+
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    void unmapTemporaryFile(void* p, std::size_t bytes) {
+        if (p) ::munmap(p, bytes == 0 ? 1 : bytes);
+    }
+
+    void adviseMapped(const void* p, std::size_t bytes, Residency r) {
+        if (!p || bytes == 0) return;
+        const std::size_t page = pageSize();
+        auto begin = reinterpret_cast<std::uintptr_t>(p);
+        auto end = begin + bytes;
+
+        if (r == Residency::WillNeed) {
+            begin &= ~(page - 1);
+            ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+            return;
+        }
+
+        // Seules les pages entierement dans la zone sont rendues : les voisines
+        // peuvent appartenir a une bande encore utilisee.
+        begin = (begin + page - 1) & ~(page - 1);
+        end &= ~(page - 1);
+        if (end <= begin) return;
+        // Sur une projection partagee, DONTNEED ne perd rien : les pages quittent le
+        // processus et restent dans le cache du fichier, que le noyau ecrit et libere
+        // a son rythme (MADV_PAGEOUT force l'ecriture et triple le temps d'un tour).
+        ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+    }
+
+    std::int64_t residentBytes(const void* p, std::size_t bytes) {
+        if (!p || bytes == 0) return 0;
+        const std::size_t page = pageSize();
+        auto begin = reinterpret_cast<std::uintptr_t>(p) & ~(page - 1);
+        auto end = reinterpret_cast<std::uintptr_t>(p) + bytes;
+        std::size_t pages = (end - begin + page - 1) / page;
+
+#if defined(__APPLE__)
+        std::vector<char> vec(pages);
+#else
+        std::vector<unsigned char> vec(pages);
+#endif
+        if (::mincore(reinterpret_cast<void*>(begin), end - begin, vec.data()) != 0) return -1;
+
+        std::int64_t resident = 0;
+        for (auto v : vec) {
+            if (v & 1) resident += static_cast<std::int64_t>(page);
+        }
+        return resident;
+    }
+
+    static std::size_t roundUp(std::size_t n, std::size_t to) {
+        return (n + to - 1) / to * to;
+    }
+
+    // Longueur reellement projetee, la meme a l'allocation et a la liberation.
+    static std::size_t anonymousLength(std::size_t bytes, PageKind kind) {
+        if (kind == PageKind::Huge && bytes >= kHugePageBytes) return roundUp(bytes, kHugePageBytes);
+        return roundUp(bytes == 0 ? 1 : bytes, pageSize());
+    }
+
+    void* mapAnonymous(std::size_t bytes, PageKind kind) {
+        const std::size_t length = anonymousLength(bytes, kind);
+        const int prot = PROT_READ | PROT_WRITE;
+        const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+        if (kind != PageKind::Huge || bytes < kHugePageBytes) {
+            void* p = ::mmap(nullptr, length, prot, flags, -1, 0);
+            return p == MAP_FAILED ? nullptr : p;
+        }
+
+#if defined(MAP_HUGETLB)
+        // Echoue des la projection si la reserve du systeme ne suffit pas.
+        void* p = ::mmap(nullptr, length, prot, flags | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) return p;
+#endif
+        // Pages transparentes : il leur faut une zone alignee sur 2 Mo.
+        void* raw = ::mmap(nullptr, length + kHugePageBytes, prot, flags, -1, 0);
+        if (raw == MAP_FAILED) return nullptr;
+        auto begin = reinterpret_cast<std::uintptr_t>(raw);
+        auto aligned = (begin + kHugePageBytes - 1) & ~(kHugePageBytes - 1);
+        if (aligned > begin) ::munmap(raw, aligned - begin);
+        std::size_t tail = begin + kHugePageBytes - aligned;
+        if (tail > 0) ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+#if defined(MADV_HUGEPAGE)
+        ::madvise(reinterpret_cast<void*>(aligned), length, MADV_HUGEPAGE);
+#endif
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void unmapAnonymous(void* p, std::size_t bytes, PageKind kind) {
+        if (p) ::munmap(p, anonymousLength(bytes, kind));
+    }
+
+    std::int64_t hugePageBytes() {
+        std::ifstream in("/proc/self/smaps_rollup");
+        if (!in) return -1;
+        // "AnonHugePages:   4096 kB", apres une ligne d'en-tete.
+        std::int64_t total = 0;
+        std::string line;
+        while (std::getline(in, line)) {
+            auto colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            std::string key = line.substr(0, colon);
+            if (key == "AnonHugePages" || key == "Private_Hugetlb" || key == "Shared_Hugetlb") {
+                total += std::strtoll(line.c_str() + colon + 1, nullptr, 10) * 1024;
+            }
+        }
+        return total;
+    }
+
+#else
+
+    // Pas de projection de fichier sur cette plateforme : les tables restent sur le
+    // tas, mises a zero comme le serait un fichier neuf.
+    void* mapTemporaryFile(const std::string&, std::size_t bytes) {
+        return std::calloc(bytes == 0 ? 1 : bytes, 1);
+    }
+
+    void unmapTemporaryFile(void* p, std::size_t) {
+        std::free(p);
+    }
+
+    void adviseMapped(const void*, std::size_t, Residency) {}
+
+    std::int64_t residentBytes(const void*, std::size_t) {
+        return -1;
+    }
+
+    void* mapAnonymous(std::size_t bytes, PageKind) {
+        return std::calloc(bytes == 0 ? 1 : bytes, 1);
+    }
+
+    void unmapAnonymous(void* p, std::size_t, PageKind) {
+        std::free(p);
+    }
+
+    std::int64_t hugePageBytes() {
+        return -1;
+    }
+
+#endif
+
+    void touchPages(void* p, std::size_t bytes) {
+        if (!p || bytes == 0) return;
+        constexpr std::size_t kPage = 4096;
+        auto* c = static_cast<unsigned char*>(p);
+        // Ecriture atomique neutre : une bande voisine peut toucher la meme page.
+        auto touch = [](unsigned char& b) { std::atomic_ref<unsigned char>(b).fetch_or(0, std::memory_order_relaxed); };
+        touch(c[0]);
+        std::size_t first = kPage - (reinterpret_cast<std::uintptr_t>(p) & (kPage - 1));
+        for (std::size_t o = first; o < bytes; o += kPage) touch(c[o]);
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "MemoryStats.h"
+
+namespace Ecosystem {
+
+    // Zone projetee depuis un fichier temporaire (supprime des sa creation) du
+    // repertoire donne. Les pages sont partagees avec le fichier : le noyau peut
+    // toujours les evincer vers le disque, la memoire vive ne garde que ce qui sert.
+    void* mapTemporaryFile(const std::string& directory, std::size_t bytes);
+    void unmapTemporaryFile(void* p, std::size_t bytes);
+
+    enum class Residency {
+        WillNeed,   // prechargement asynchrone
+        Release     // retire les pages du processus (conservees dans le fichier)
+    };
+
+    // Conseil au noyau sur [p, p + bytes) ; sans effet hors des zones projetees.
+    void adviseMapped(const void* p, std::size_t bytes, Residency r);
+    // Octets de [p, p + bytes) presents dans le cache de pages (mincore) ; -1 si inconnu.
+    std::int64_t residentBytes(const void* p, std::size_t bytes);
+
+    constexpr std::size_t kHugePageBytes = std::size_t(2) << 20;
+
+    enum class PageKind : std::uint8_t {
+        Heap,       // operator new
+        Anonymous,  // projection anonyme : pages nulles, allouees au premier acces
+        Huge        // idem sur pages enormes quand la zone en couvre au moins une
+    };
+
+    // Zone anonyme mise a zero dont aucune page n'est encore touchee : chacune est
+    // allouee sur le noeud NUMA du premier thread qui y accede. En Huge, essaie les
+    // pages enormes reservees puis les pages transparentes (zone alignee sur 2 Mo) ;
+    // sans l'une ni l'autre ce sont des pages ordinaires.
+    void* mapAnonymous(std::size_t bytes, PageKind kind);
+    void unmapAnonymous(void* p, std::size_t bytes, PageKind kind);
+    // Touche une fois chaque page de [p, p + bytes) sans changer son contenu.
+    void touchPages(void* p, std::size_t bytes);
+    // Octets du processus sur pages enormes (transparentes ou reservees) ; -1 si inconnu.
+    std::int64_t hugePageBytes();
+
+    // Allocateur des grandes tables par cellule : sur le tas (comptabilise dans C),
+    // en projection anonyme (PageKind, toujours dans C) ou, si un repertoire est
+    // donne, dans un fichier projete (categorie Mapped). Dans un fichier ou une zone
+    // anonyme neufs les pages valent zero : les elements dont la valeur par defaut
+    // est nulle ne sont pas construits, pour ne pas tout charger ni tout placer.
+    template <class T, MemCategory C>
+    class CellAllocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        template <class U>
+        struct rebind { using other = CellAllocator<U, C>; };
+
+        CellAllocator() = default;
+        explicit CellAllocator(std::shared_ptr<const std::string> directory, PageKind pages = PageKind::Heap)
+            : m_directory(std::move(directory)), m_pages(pages) {}
+        template <class U>
+        CellAllocator(const CellAllocator<U, C>& o) noexcept : m_directory(o.directory()), m_pages(o.pages()) {}
+
+        bool mapped() const { return m_directory != nullptr; }
+        const std::shared_ptr<const std::string>& directory() const { return m_directory; }
+        PageKind pages() const { return m_pages; }
+        // Zones neuves nulles et jamais touchees.
+        bool untouched() const { return mapped() || m_pages != PageKind::Heap; }
+
+        T* allocate(std::size_t n) {
+            std::size_t bytes = n * sizeof(T);
+            if (!mapped() && m_pages == PageKind::Heap) {
+                T* p = static_cast<T*>(::operator new(bytes));
+                MemoryStats::I().onAlloc(C, bytes);
+                return p;
+            }
+            if (!mapped()) {
+                void* p = mapAnonymous(bytes, m_pages);
+                if (!p) throw std::bad_alloc();
+                MemoryStats::I().onAlloc(C, bytes);
+                return static_cast<T*>(p);
+            }
+            void* p = mapTemporaryFile(*m_directory, bytes);
+            if (!p) throw std::bad_alloc();
+            MemoryStats::I().onAlloc(MemCategory::Mapped, bytes);
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept {
+            std::size_t bytes = n * sizeof(T);
+            if (!mapped() && m_pages == PageKind::Heap) {
+                MemoryStats::I().onFree(C, bytes);
+                ::operator delete(p, bytes);
+                return;
+            }
+            if (!mapped()) {
+                MemoryStats::I().onFree(C, bytes);
+                unmapAnonymous(p, bytes, m_pages);
+                return;
+            }
+            MemoryStats::I().onFree(MemCategory::Mapped, bytes);
+            unmapTemporaryFile(p, bytes);
+        }
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args) {
+            if constexpr (sizeof...(Args) == 0) {
+                if (untouched() && zeroIsDefault<U>()) return;
+            }
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+
+        template <class U>
+        bool operator==(const CellAllocator<U, C>& o) const noexcept {
+            return m_directory == o.directory() && m_pages == o.pages();
+        }
+        template <class U>
+        bool operator!=(const CellAllocator<U, C>& o) const noexcept { return !(*this == o); }
+
+    private:
+        std::shared_ptr<const std::string> m_directory;
+        PageKind m_pages = PageKind::Heap;
+
+        // Verifie une fois que la valeur par defaut de U est faite d'octets nuls.
+        template <class U>
+        static bool zeroIsDefault() {
+            static const bool zero = [] {
+                alignas(U) unsigned char buf[sizeof(U)];
+                for (unsigned char& b : buf) b = 0xA5;
+                U* u = ::new (static_cast<void*>(buf)) U();
+                bool allZero = true;
+                for (unsigned char b : buf) allZero = allZero && b == 0;
+                u->~U();
+                return allZero;
+            }();
+            return zero;
+        }
+    };
+}
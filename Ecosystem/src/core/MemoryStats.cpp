@@ -0,0 +1,21 @@
+#include "MemoryStats.h"
+
+namespace Ecosystem {
+
+    template <MemCategory C>
+    void* TrackedAlloc<C>::operator new(std::size_t n) {
+        void* p = ::operator new(n);
+        MemoryStats::I().onAlloc(C, n);
+        return p;
+    }
+
+    template <MemCategory C>
+    void TrackedAlloc<C>::operator delete(void* p, std::size_t n) {
+        MemoryStats::I().onFree(C, n);
+        ::operator delete(p, n);
+    }
+
+    template struct TrackedAlloc<MemCategory::Animals>;
+    template struct TrackedAlloc<MemCategory::Plants>;
+    template struct TrackedAlloc<MemCategory::Strategies>;
+}
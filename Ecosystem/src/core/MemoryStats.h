@@ -0,0 +1,144 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace Ecosystem {
+
+    enum class MemCategory {
+        Grid,
+        Animals,
+        Plants,
+        Strategies,
+        Scratch,
+        Output,
+        // Tables par cellule projetees depuis un fichier (voir MappedStorage.h).
+        Mapped,
+        Count
+    };
+
+    // Comptabilite des allocations par sous-systeme.
+    // Les compteurs sont globaux au processus (toutes les World confondues).
+    class MemoryStats {
+    public:
+        struct Counter {
+            std::int64_t liveBytes = 0;
+            std::int64_t peakBytes = 0;
+            std::int64_t allocations = 0;
+            std::int64_t frees = 0;
+        };
+
+        static constexpr std::size_t kCategories = static_cast<std::size_t>(MemCategory::Count);
+        using Snapshot = std::array<Counter, kCategories>;
+
+        static MemoryStats& I() {
+            static MemoryStats inst;
+            return inst;
+        }
+
+        void onAlloc(MemCategory c, std::size_t bytes) {
+            auto& s = m_slots[static_cast<std::size_t>(c)];
+            std::int64_t live = s.liveBytes.fetch_add(static_cast<std::int64_t>(bytes), std::memory_order_relaxed)
+                + static_cast<std::int64_t>(bytes);
+            s.allocations.fetch_add(1, std::memory_order_relaxed);
+
+            std::int64_t peak = s.peakBytes.load(std::memory_order_relaxed);
+            while (live > peak && !s.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        }
+
+        void onFree(MemCategory c, std::size_t bytes) {
+            auto& s = m_slots[static_cast<std::size_t>(c)];
+            s.liveBytes.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+            s.frees.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Allocation dont la duree de vie echappe au suivi (chaines rendues a l'appelant).
+        void onTransient(MemCategory c, std::size_t bytes) {
+            onAlloc(c, bytes);
+            onFree(c, bytes);
+        }
+
+        Snapshot snapshot() const {
+            Snapshot out{};
+            for (std::size_t i = 0; i < kCategories; ++i) {
+                out[i].liveBytes = m_slots[i].liveBytes.load(std::memory_order_relaxed);
+                out[i].peakBytes = m_slots[i].peakBytes.load(std::memory_order_relaxed);
+                out[i].allocations = m_slots[i].allocations.load(std::memory_order_relaxed);
+                out[i].frees = m_slots[i].frees.load(std::memory_order_relaxed);
+            }
+            return out;
+        }
+
+        std::int64_t totalAllocations() const {
+            std::int64_t n = 0;
+            for (auto const& s : m_slots) n += s.allocations.load(std::memory_order_relaxed);
+            return n;
+        }
+
+        static const char* name(MemCategory c) {
+            switch (c) {
+            case MemCategory::Grid: return "grid";
+            case MemCategory::Animals: return "animals";
+            case MemCategory::Plants: return "plants";
+            case MemCategory::Strategies: return "strategies";
+            case MemCategory::Scratch: return "scratch";
+            case MemCategory::Output: return "output";
+            case MemCategory::Mapped: return "mapped";
+            default: return "?";
+            }
+        }
+
+    private:
+        struct Slot {
+            std::atomic<std::int64_t> liveBytes{ 0 };
+            std::atomic<std::int64_t> peakBytes{ 0 };
+            std::atomic<std::int64_t> allocations{ 0 };
+            std::atomic<std::int64_t> frees{ 0 };
+        };
+
+        MemoryStats() = default;
+        std::array<Slot, kCategories> m_slots;
+    };
+
+    // Base a heriter pour comptabiliser les new/delete d'une hierarchie.
+    template <MemCategory C>
+    struct TrackedAlloc {
+        static void* operator new(std::size_t n);
+        static void operator delete(void* p, std::size_t n);
+    };
+
+    extern template struct TrackedAlloc<MemCategory::Animals>;
+    extern template struct TrackedAlloc<MemCategory::Plants>;
+    extern template struct TrackedAlloc<MemCategory::Strategies>;
+
+    // Allocateur de conteneur comptabilise dans une categorie.
+    template <class T, MemCategory C>
+    struct TrackingAllocator {
+        using value_type = T;
+
+        template <class U>
+        struct rebind { using other = TrackingAllocator<U, C>; };
+
+        TrackingAllocator() = default;
+        template <class U>
+        TrackingAllocator(const TrackingAllocator<U, C>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            T* p = static_cast<T*>(::operator new(n * sizeof(T)));
+            MemoryStats::I().onAlloc(C, n * sizeof(T));
+            return p;
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept {
+            MemoryStats::I().onFree(C, n * sizeof(T));
+            ::operator delete(p, n * sizeof(T));
+        }
+
+        template <class U>
+        bool operator==(const TrackingAllocator<U, C>&) const noexcept { return true; }
+        template <class U>
+        bool operator!=(const TrackingAllocator<U, C>&) const noexcept { return false; }
+    };
+}
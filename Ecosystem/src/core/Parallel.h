@@ -0,0 +1,35 @@
+#pragma once
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace Ecosystem {
+
+    inline unsigned workerCount() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    // Decoupe [0, count) en tranches contigues, une par thread.
+    // En dessous de minPerThread elements par tranche, tout s'execute sur l'appelant.
+    template <class Fn>
+    void parallelFor(std::size_t count, std::size_t minPerThread, Fn&& fn) {
+        std::size_t threads = std::min<std::size_t>(workerCount(), count / std::max<std::size_t>(minPerThread, 1));
+        if (threads <= 1) {
+            fn(std::size_t{ 0 }, count);
+            return;
+        }
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        std::size_t chunk = (count + threads - 1) / threads;
+        for (std::size_t t = 1; t < threads; ++t) {
+            std::size_t begin = t * chunk;
+            std::size_t end = std::min(count, begin + chunk);
+            if (begin >= end) break;
+            pool.emplace_back([&fn, begin, end] { fn(begin, end); });
+        }
+        fn(std::size_t{ 0 }, std::min(count, chunk));
+        for (auto& th : pool) th.join();
+    }
+}
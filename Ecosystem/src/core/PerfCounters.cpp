@@ -0,0 +1,216 @@
+#include "PerfCounters.h"
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Ecosystem {
+
+    double PerfCounters::Sample::ipc() const {
+        auto cycles = events[static_cast<std::size_t>(PerfEvent::Cycles)];
+        auto instructions = events[static_cast<std::size_t>(PerfEvent::Instructions)];
+        return cycles ? static_cast<double>(instructions) / cycles : 0.0;
+    }
+
+    void PerfCounters::Sample::add(const Sample& o) {
+        for (std::size_t e = 0; e < kEvents; ++e) events[e] += o.events[e];
+        seconds += o.seconds;
+        calls += o.calls;
+    }
+
+    const char* PerfCounters::name(PerfScope s) {
+        switch (s) {
+        case PerfScope::Move: return "move";
+        case PerfScope::Feed: return "feed";
+        case PerfScope::Reproduce: return "reproduce";
+        case PerfScope::Spread: return "spread";
+        case PerfScope::Aging: return "aging";
+        case PerfScope::Occupancy: return "occupancy";
+        case PerfScope::LevelOfDetail: return "lod";
+        case PerfScope::Render: return "render";
+        default: return "?";
+        }
+    }
+
+    const char* PerfCounters::name(PerfEvent e) {
+        switch (e) {
+        case PerfEvent::Cycles: return "cycles";
+        case PerfEvent::Instructions: return "instr";
+        case PerfEvent::CacheMisses: return "cache-miss";
+        case PerfEvent::BranchMisses: return "branch-miss";
+        case PerfEvent::DTlbMisses: return "dtlb-miss";
+        default: return "?";
+        }
+    }
+
+#if defined(__linux__)
+
+    static int openEvent(std::uint32_t type, std::uint64_t config, int groupFd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = groupFd < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+
+    bool PerfCounters::enable() {
+        m_enabled = true;
+        if (m_opened > 0) return true;
+
+        struct Spec { PerfEvent event; std::uint32_t type; std::uint64_t config; };
+        const Spec specs[] = {
+            { PerfEvent::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+            { PerfEvent::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+            { PerfEvent::CacheMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+            { PerfEvent::BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+            { PerfEvent::DTlbMisses, PERF_TYPE_HW_CACHE,
+              PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        };
+
+        // Le premier evenement ouvert mene le groupe ; ceux que la machine refuse sont ignores.
+        for (auto const& spec : specs) {
+            int fd = openEvent(spec.type, spec.config, m_leader);
+            if (fd < 0) {
+                if (m_reason.empty()) m_reason = std::string(name(spec.event)) + " : " + std::strerror(errno);
+                continue;
+            }
+            if (m_leader < 0) m_leader = fd;
+            m_fds[static_cast<std::size_t>(spec.event)] = fd;
+            m_slot[static_cast<std::size_t>(spec.event)] = m_opened++;
+        }
+        if (m_leader < 0) return false;
+
+        ::ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return true;
+    }
+
+    PerfCounters::~PerfCounters() {
+        for (int fd : m_fds) {
+            if (fd >= 0) ::close(fd);
+        }
+    }
+
+    // Lecture de groupe : nb, temps active, temps compte, puis une valeur par evenement.
+    // Les valeurs sont extrapolees si le noyau a multiplexe les compteurs.
+    void PerfCounters::read(Reading& r) const {
+        r.time = std::chrono::steady_clock::now();
+        if (m_leader < 0) return;
+
+        std::uint64_t buf[3 + kEvents] = {};
+        if (::read(m_leader, buf, sizeof(buf)) < static_cast<ssize_t>(3 * sizeof(std::uint64_t))) return;
+
+        double scale = (buf[2] > 0 && buf[2] < buf[1]) ? static_cast<double>(buf[1]) / buf[2] : 1.0;
+        for (std::size_t e = 0; e < kEvents; ++e) {
+            int slot = m_slot[e];
+            if (slot >= 0 && static_cast<std::uint64_t>(slot) < buf[0]) {
+                r.events[e] = static_cast<std::uint64_t>(buf[3 + slot] * scale);
+            }
+        }
+    }
+
+#else
+
+    bool PerfCounters::enable() {
+        m_enabled = true;
+        m_reason = "perf_event_open indisponible sur ce systeme";
+        return false;
+    }
+
+    PerfCounters::~PerfCounters() = default;
+
+    void PerfCounters::read(Reading& r) const {
+        r.time = std::chrono::steady_clock::now();
+    }
+
+#endif
+
+    void PerfCounters::begin(PerfScope s) {
+        read(m_start[static_cast<std::size_t>(s)]);
+    }
+
+    void PerfCounters::end(PerfScope s) {
+        Reading now;
+        read(now);
+        auto const& start = m_start[static_cast<std::size_t>(s)];
+        Sample& cur = m_current[static_cast<std::size_t>(s)];
+
+        for (std::size_t e = 0; e < kEvents; ++e) {
+            cur.events[e] += now.events[e] >= start.events[e] ? now.events[e] - start.events[e] : 0;
+        }
+        cur.seconds += std::chrono::duration<double>(now.time - start.time).count();
+        cur.calls++;
+    }
+
+    void PerfCounters::endTurn() {
+        for (std::size_t s = 0; s < kScopes; ++s) {
+            m_turn[s] = m_current[s];
+            m_total[s].add(m_current[s]);
+            m_current[s] = Sample{};
+        }
+        m_turns++;
+    }
+
+    // Une ligne par tour : temps, IPC et defauts de cache par section.
+    std::string PerfCounters::turnLine(int turn) const {
+        std::ostringstream out;
+        out << "Perf " << turn << " |";
+        for (std::size_t s = 0; s < kScopes; ++s) {
+            auto const& t = m_turn[s];
+            if (t.calls == 0) continue;
+            out << ' ' << name(static_cast<PerfScope>(s)) << '=' << std::fixed << std::setprecision(3)
+                << t.seconds * 1000.0 << "ms";
+            if (hasCounters()) {
+                out << " ipc=" << std::setprecision(2) << t.ipc();
+                if (hasEvent(PerfEvent::CacheMisses)) out << " cm=" << t.events[static_cast<std::size_t>(PerfEvent::CacheMisses)];
+            }
+        }
+        return out.str();
+    }
+
+    std::string PerfCounters::summary() const {
+        std::ostringstream out;
+        out << "Compteurs (" << m_turns << " tours";
+        if (!hasCounters()) out << ", temps seulement : " << (m_reason.empty() ? "compteurs coupes" : m_reason);
+        out << ") :\n";
+
+        out << "  " << std::left << std::setw(10) << "section" << std::right
+            << std::setw(12) << "ms/tour" << std::setw(8) << "ipc";
+        for (std::size_t e = 0; e < kEvents; ++e) {
+            if (e == static_cast<std::size_t>(PerfEvent::Cycles) || e == static_cast<std::size_t>(PerfEvent::Instructions)) continue;
+            out << std::setw(14) << (std::string(name(static_cast<PerfEvent>(e))) + "/t");
+        }
+        out << "\n";
+
+        double turns = m_turns > 0 ? m_turns : 1;
+        for (std::size_t s = 0; s < kScopes; ++s) {
+            auto const& t = m_total[s];
+            if (t.calls == 0) continue;
+            out << "  " << std::left << std::setw(10) << name(static_cast<PerfScope>(s)) << std::right
+                << std::fixed << std::setprecision(3) << std::setw(12) << t.seconds * 1000.0 / turns;
+
+            if (hasEvent(PerfEvent::Cycles) && hasEvent(PerfEvent::Instructions)) out << std::setprecision(2) << std::setw(8) << t.ipc();
+            else out << std::setw(8) << "-";
+
+            for (std::size_t e = 0; e < kEvents; ++e) {
+                if (e == static_cast<std::size_t>(PerfEvent::Cycles) || e == static_cast<std::size_t>(PerfEvent::Instructions)) continue;
+                if (hasEvent(static_cast<PerfEvent>(e))) out << std::setprecision(0) << std::setw(14) << t.events[e] / turns;
+                else out << std::setw(14) << "-";
+            }
+            out << "\n";
+        }
+        return out.str();
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Ecosystem {
+
+    enum class PerfEvent {
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        DTlbMisses,
+        Count
+    };
+
+    // Sections mesurees : les systemes de World::step et l'affichage.
+    enum class PerfScope {
+        Move,
+        Feed,
+        Reproduce,
+        Spread,
+        Aging,
+        Occupancy,
+        LevelOfDetail,
+        Render,
+        Count
+    };
+
+    // Compteurs materiels par section (perf_event_open, Linux), lus en groupe
+    // sur le thread appelant. Sans compteurs disponibles (autre systeme,
+    // perf_event_paranoid, machine virtuelle), seul le temps est mesure.
+    // Non thread-safe : a utiliser depuis le thread qui fait avancer la World.
+    class PerfCounters {
+    public:
+        static constexpr std::size_t kEvents = static_cast<std::size_t>(PerfEvent::Count);
+        static constexpr std::size_t kScopes = static_cast<std::size_t>(PerfScope::Count);
+
+        struct Sample {
+            std::array<std::uint64_t, kEvents> events{};
+            double seconds = 0.0;
+            std::uint64_t calls = 0;
+
+            double ipc() const;
+            void add(const Sample& o);
+        };
+
+        static PerfCounters& I() {
+            static PerfCounters inst;
+            return inst;
+        }
+
+        ~PerfCounters();
+
+        // Active les mesures et ouvre les compteurs ; faux si aucun compteur
+        // n'est disponible, auquel cas seul le temps est mesure.
+        bool enable();
+        bool enabled() const { return m_enabled; }
+        bool hasCounters() const { return m_opened > 0; }
+        bool hasEvent(PerfEvent e) const { return m_slot[static_cast<std::size_t>(e)] >= 0; }
+        const std::string& unavailableReason() const { return m_reason; }
+
+        void begin(PerfScope s);
+        void end(PerfScope s);
+
+        // Cloture le tour : les mesures du tour passent dans le cumul.
+        void endTurn();
+
+        const Sample& lastTurn(PerfScope s) const { return m_turn[static_cast<std::size_t>(s)]; }
+        const Sample& total(PerfScope s) const { return m_total[static_cast<std::size_t>(s)]; }
+        int turns() const { return m_turns; }
+
+        std::string turnLine(int turn) const;
+        std::string summary() const;
+
+        static const char* name(PerfScope s);
+        static const char* name(PerfEvent e);
+
+    private:
+        PerfCounters() = default;
+
+        struct Reading {
+            std::array<std::uint64_t, kEvents> events{};
+            std::chrono::steady_clock::time_point time;
+        };
+
+        bool m_enabled = false;
+        int m_leader = -1;
+        std::array<int, kEvents> m_fds{ -1, -1, -1, -1, -1 };
+        // Position de chaque evenement dans la lecture de groupe, -1 si absent.
+        std::array<int, kEvents> m_slot{ -1, -1, -1, -1, -1 };
+        int m_opened = 0;
+        std::string m_reason;
+
+        std::array<Reading, kScopes> m_start{};
+        std::array<Sample, kScopes> m_current{};
+        std::array<Sample, kScopes> m_turn{};
+        std::array<Sample, kScopes> m_total{};
+        int m_turns = 0;
+
+        void read(Reading& r) const;
+    };
+
+    // Mesure la portee courante ; ne coute qu'un test si les mesures sont coupees.
+    class PerfSection {
+    public:
+        explicit PerfSection(PerfScope s) : m_scope(s), m_active(PerfCounters::I().enabled()) {
+            if (m_active) PerfCounters::I().begin(m_scope);
+        }
+        ~PerfSection() {
+            if (m_active) PerfCounters::I().end(m_scope);
+        }
+
+        PerfSection(const PerfSection&) = delete;
+        PerfSection& operator=(const PerfSection&) = delete;
+
+    private:
+        PerfScope m_scope;
+        bool m_active;
+    };
+}
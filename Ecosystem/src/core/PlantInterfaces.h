@@ -3,6 +3,7 @@
 
 namespace Ecosystem {
 	struct IPlant : public IEntity {
-		virtual void age_one_trun() = 0;
+		// Age au tour turn.
+		virtual int age(int turn) const = 0;
 	};
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Interfaces.h"
 #include "world/Cell.h"
 #include <array>
+#include <utility>
 #include <cstdlib>
 #include <limits>
 #include <cmath>
@@ -17,7 +18,7 @@ namespace Ecosystem {
             {  0, -1}
         } };
 
-        int index = std::rand() % 4;
+        int index = world.randomInt(RandomStream::Move, x, y, 4);
         auto [dx, dy] = directions[index];
         return { x + dx, y + dy };
     }
@@ -33,23 +34,22 @@ namespace Ecosystem {
         int predatorX = 0, predatorY = 0;
         int bestDist = std::numeric_limits<int>::max();
 
-        for (int dy = -dangerRadius; dy <= dangerRadius; ++dy) {
-            for (int dx = -dangerRadius; dx <= dangerRadius; ++dx) {
-                int nx = x + dx;
-                int ny = y + dy;
-                const Cell* c = world.getCell(nx, ny);
-                if (!c || !c->animal) continue;
-                if (c->animal->kind() == AnimalKind::Carnivore) {
-                    int d = manhattan(x, y, nx, ny);
-                    if (d < bestDist) {
-                        bestDist = d;
-                        predatorCell = c;
-                        predatorX = nx;
-                        predatorY = ny;
-                    }
+        if (world.countInRadius(OccupancyLayer::Carnivores, x, y, dangerRadius) == 0) {
+            return { x, y };
+        }
+
+        world.forEachInWindow(x, y, dangerRadius, [&](const Cell& c, int nx, int ny) {
+            if (!c.animal) return;
+            if (c.animal->kind() == AnimalKind::Carnivore) {
+                int d = manhattan(x, y, nx, ny);
+                if (d < bestDist) {
+                    bestDist = d;
+                    predatorCell = &c;
+                    predatorX = nx;
+                    predatorY = ny;
                 }
             }
-        }
+        });
 
         if (!predatorCell) {
             return { x, y };
@@ -84,24 +84,21 @@ namespace Ecosystem {
     }
 
     bool SmartHerbivoreMove::find_nearest_plant(const World& world, int x, int y, int radius, Position& out) {
+        if (world.countInRadius(OccupancyLayer::Plants, x, y, radius) == 0) return false;
+
         int bestDist = std::numeric_limits<int>::max();
         bool found = false;
 
-        for (int dy = -radius; dy <= radius; ++dy) {
-            for (int dx = -radius; dx <= radius; ++dx) {
-                int nx = x + dx;
-                int ny = y + dy;
-                const Cell* c = world.getCell(nx, ny);
-                if (!c || !c->plant) continue;
+        world.forEachInWindow(x, y, radius, [&](const Cell& c, int nx, int ny) {
+            if (!c.plant) return;
 
-                int d = manhattan(x, y, nx, ny);
-                if (d < bestDist) {
-                    bestDist = d;
-                    out = { nx, ny };
-                    found = true;
-                }
+            int d = manhattan(x, y, nx, ny);
+            if (d < bestDist) {
+                bestDist = d;
+                out = { nx, ny };
+                found = true;
             }
-        }
+        });
         return found;
     }
 
@@ -111,31 +108,27 @@ namespace Ecosystem {
 
         IAnimal& self = *current->animal;
         if (self.kind() != AnimalKind::Herbivore) return false;
-        if (self.repro_cooldown_ref() > 0) return false;
+        if (self.timers().cooldown(world.turn()) > 0) return false;
+        if (world.countInRadius(OccupancyLayer::Herbivores, x, y, radius) <= 1) return false;
 
         int bestDist = std::numeric_limits<int>::max();
         bool found = false;
 
-        for (int dy = -radius; dy <= radius; ++dy) {
-            for (int dx = -radius; dx <= radius; ++dx) {
-                int nx = x + dx;
-                int ny = y + dy;
-                const Cell* c = world.getCell(nx, ny);
-                if (!c || !c->animal) continue;
+        world.forEachInWindow(x, y, radius, [&](const Cell& c, int nx, int ny) {
+            if (!c.animal) return;
 
-                IAnimal& other = *c->animal;
-                if (other.kind() != AnimalKind::Herbivore) continue;
-                if (other.gender() == self.gender()) continue; 
-                if (other.repro_cooldown_ref() > 0) continue;
+            const IAnimal& other = *c.animal;
+            if (other.kind() != AnimalKind::Herbivore) return;
+            if (other.gender() == self.gender()) return;
+            if (other.timers().cooldown(world.turn()) > 0) return;
 
-                int d = manhattan(x, y, nx, ny);
-                if (d < bestDist) {
-                    bestDist = d;
-                    out = { nx, ny };
-                    found = true;
-                }
+            int d = manhattan(x, y, nx, ny);
+            if (d < bestDist) {
+                bestDist = d;
+                out = { nx, ny };
+                found = true;
             }
-        }
+        });
         return found;
     }
 
@@ -152,7 +145,7 @@ namespace Ecosystem {
         return { x, y };
     }
 
-    Position SmartHerbivoreMove::random_step(int x, int y) {
+    Position SmartHerbivoreMove::random_step(const World& world, int x, int y) {
         static const std::array<std::pair<int, int>, 4> directions{ {
             {  1,  0},
             { -1,  0},
@@ -160,7 +153,7 @@ namespace Ecosystem {
             {  0, -1}
         } };
 
-        int index = std::rand() % 4;
+        int index = world.randomInt(RandomStream::Move, x, y, 4);
         auto [dx, dy] = directions[index];
         return { x + dx, y + dy };
     }
@@ -183,73 +176,54 @@ namespace Ecosystem {
             return step;
         }
 
-        return random_step(x, y);
+        return random_step(world, x, y);
     }
 
     // HerbivoreFeeding
 
     void HerbivoreFeeding::try_feed(World& world, int x, int y) {
-        Cell* cell = world.getCell(x, y);
+        const Cell* cell = std::as_const(world).getCell(x, y);
         if (!cell || !cell->animal) return;
 
         if (cell->plant && cell->animal) {
-            cell->plant.reset();
-            cell->animal->satiety_ref() = world.cfg().satiety_after_eat;
-            cell->animal->hungery_ref() = 0;
+            world.eatPlant(x, y);
+            world.feedAnimal(x, y);
         }
     }
 
     // CarnivoreFeeding
 
     void CarnivoreFeeding::try_feed(World& world, int x, int y) {
-        Cell* current = world.getCell(x, y);
+        const Cell* current = std::as_const(world).getCell(x, y);
         if (!current || !current->animal) return;
 
-        static const std::array<std::pair<int, int>, 4> directions{ {
-            {  1,  0},
-            { -1,  0},
-            {  0,  1},
-            {  0, -1}
-        } };
-
-        for (auto [dx, dy] : directions) {
-            int nx = x + dx;
-            int ny = y + dy;
-
-            Cell* ncell = world.getCell(nx, ny);
-            if (!ncell) continue;
-
-            if (ncell->animal && ncell->animal->kind() == AnimalKind::Herbivore) {
-                ncell->animal.reset();
-                current->animal->satiety_ref() = world.cfg().satiety_after_eat;
-                current->animal->hungery_ref() = 0;
-                break;
-            }
-        }
+        world.forEachNeighbor(x, y, [&](const Cell& ncell, int nx, int ny) {
+            if (!ncell.animal || ncell.animal->kind() != AnimalKind::Herbivore) return false;
+            world.killAnimal(nx, ny);
+            world.feedAnimal(x, y);
+            return true;
+        });
     }
 
 
     bool SmartCarnivoreMove::find_nearest_prey(const World& world, int x, int y, int radius, Position& out) {
+        if (world.countInRadius(OccupancyLayer::Herbivores, x, y, radius) == 0) return false;
+
         int bestDist = std::numeric_limits<int>::max();
         bool found = false;
 
-        for (int dy = -radius; dy <= radius; ++dy) {
-            for (int dx = -radius; dx <= radius; ++dx) {
-                int nx = x + dx;
-                int ny = y + dy;
-                const Cell* c = world.getCell(nx, ny);
-                if (!c || !c->animal) continue;
+        world.forEachInWindow(x, y, radius, [&](const Cell& c, int nx, int ny) {
+            if (!c.animal) return;
 
-                if (c->animal->kind() != AnimalKind::Herbivore) continue;
+            if (c.animal->kind() != AnimalKind::Herbivore) return;
 
-                int d = manhattan(x, y, nx, ny);
-                if (d < bestDist) {
-                    bestDist = d;
-                    out = { nx, ny };
-                    found = true;
-                }
+            int d = manhattan(x, y, nx, ny);
+            if (d < bestDist) {
+                bestDist = d;
+                out = { nx, ny };
+                found = true;
             }
-        }
+        });
         return found;
     }
 
@@ -259,31 +233,27 @@ namespace Ecosystem {
 
         IAnimal& self = *current->animal;
         if (self.kind() != AnimalKind::Carnivore) return false;
-        if (self.repro_cooldown_ref() > 0) return false;
+        if (self.timers().cooldown(world.turn()) > 0) return false;
+        if (world.countInRadius(OccupancyLayer::Carnivores, x, y, radius) <= 1) return false;
 
         int bestDist = std::numeric_limits<int>::max();
         bool found = false;
 
-        for (int dy = -radius; dy <= radius; ++dy) {
-            for (int dx = -radius; dx <= radius; ++dx) {
-                int nx = x + dx;
-                int ny = y + dy;
-                const Cell* c = world.getCell(nx, ny);
-                if (!c || !c->animal) continue;
+        world.forEachInWindow(x, y, radius, [&](const Cell& c, int nx, int ny) {
+            if (!c.animal) return;
 
-                IAnimal& other = *c->animal;
-                if (other.kind() != AnimalKind::Carnivore) continue;
-                if (other.gender() == self.gender()) continue;
-                if (other.repro_cooldown_ref() > 0) continue;
+            const IAnimal& other = *c.animal;
+            if (other.kind() != AnimalKind::Carnivore) return;
+            if (other.gender() == self.gender()) return;
+            if (other.timers().cooldown(world.turn()) > 0) return;
 
-                int d = manhattan(x, y, nx, ny);
-                if (d < bestDist) {
-                    bestDist = d;
-                    out = { nx, ny };
-                    found = true;
-                }
+            int d = manhattan(x, y, nx, ny);
+            if (d < bestDist) {
+                bestDist = d;
+                out = { nx, ny };
+                found = true;
             }
-        }
+        });
         return found;
     }
 
@@ -300,7 +270,7 @@ namespace Ecosystem {
         return { x, y };
     }
 
-    Position SmartCarnivoreMove::random_step(int x, int y) {
+    Position SmartCarnivoreMove::random_step(const World& world, int x, int y) {
         static const std::array<std::pair<int, int>, 4> directions{ {
             {  1,  0},
             { -1,  0},
@@ -308,7 +278,7 @@ namespace Ecosystem {
             {  0, -1}
         } };
 
-        int index = std::rand() % 4;
+        int index = world.randomInt(RandomStream::Move, x, y, 4);
         auto [dx, dy] = directions[index];
         return { x + dx, y + dy };
     }
@@ -326,7 +296,7 @@ namespace Ecosystem {
             return step;
         }
 
-        return random_step(x, y);
+        return random_step(world, x, y);
     }
 
 }
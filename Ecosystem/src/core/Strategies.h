@@ -1,17 +1,18 @@
 #pragma once
 #include "Interfaces.h"
+#include "MemoryStats.h"
 
 class World;
 
 namespace Ecosystem {
-	class RandomWalk : public IMovementStrategy {
+	class RandomWalk : public IMovementStrategy, public TrackedAlloc<MemCategory::Strategies> {
 	public :
 		explicit RandomWalk() = default;
 
 		Position choose_next(const World& world, int x, int y) override;
 	};
 
-	class SmartHerbivoreMove : public IMovementStrategy {
+	class SmartHerbivoreMove : public IMovementStrategy, public TrackedAlloc<MemCategory::Strategies> {
 		public :
 		Position choose_next(const World& world, int x, int y) override;
 	private :
@@ -19,25 +20,25 @@ namespace Ecosystem {
 		bool find_nearest_plant(const World& world, int x, int y, int radius, Position& out);
 		bool find_nearest_mate(const World& world, int x, int y, int radius, Position& out);
 		Position step_towards(int x, int y, const Position& target);
-		Position random_step(int x, int y);
+		Position random_step(const World& world, int x, int y);
 	};
 
-	class SmartCarnivoreMove : public IMovementStrategy {
+	class SmartCarnivoreMove : public IMovementStrategy, public TrackedAlloc<MemCategory::Strategies> {
 	public:
 		Position choose_next(const World& world, int x, int y) override;
 	private:
 		bool find_nearest_prey(const World& world, int x, int y, int radius, Position& out);
 		bool find_nearest_mate(const World& world, int x, int y, int radius, Position& out);
 		Position step_towards(int x, int y, const Position& target);
-		Position random_step(int x, int y);
+		Position random_step(const World& world, int x, int y);
 	};
 
-	class HerbivoreFeeding : public IFeedingStrategy {
+	class HerbivoreFeeding : public IFeedingStrategy, public TrackedAlloc<MemCategory::Strategies> {
 	public :
 		void try_feed(class World& world, int x, int y) override;
 	};
 
-	class CarnivoreFeeding : public IFeedingStrategy {
+	class CarnivoreFeeding : public IFeedingStrategy, public TrackedAlloc<MemCategory::Strategies> {
 	public :
 		void try_feed(class World& world, int x, int y) override;
 	};
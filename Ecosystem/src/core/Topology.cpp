@@ -0,0 +1,75 @@
+#include "Topology.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace Ecosystem {
+
+    // Liste du noyau : "0-3,8-11".
+    static std::vector<int> parseList(const std::string& text) {
+        std::vector<int> out;
+        std::istringstream in(text);
+        std::string range;
+        while (std::getline(in, range, ',')) {
+            int first = 0, last = -1;
+            auto dash = range.find('-');
+            try {
+                first = std::stoi(range.substr(0, dash));
+                last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            }
+            catch (...) {
+                continue;
+            }
+            for (int k = first; k <= last; ++k) out.push_back(k);
+        }
+        return out;
+    }
+
+    static std::string readLine(const std::string& path) {
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line);
+        return line;
+    }
+
+    Topology::Topology() {
+#if defined(__linux__)
+        const std::string root = "/sys/devices/system/node/";
+        for (int node : parseList(readLine(root + "online"))) {
+            auto cpus = parseList(readLine(root + "node" + std::to_string(node) + "/cpulist"));
+            if (!cpus.empty()) m_cpus.push_back(std::move(cpus));
+        }
+#endif
+        if (m_cpus.empty()) {
+            unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            m_cpus.emplace_back();
+            for (unsigned k = 0; k < n; ++k) m_cpus.back().push_back(static_cast<int>(k));
+        }
+    }
+
+    int Topology::nodeOfRow(int y, int height) const {
+        if (height <= 0) return 0;
+        long long node = static_cast<long long>(std::clamp(y, 0, height - 1)) * nodes() / height;
+        return static_cast<int>(node);
+    }
+
+    bool Topology::pinToNode(int node) const {
+        if (nodes() <= 1 || node < 0 || node >= nodes()) return false;
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : m_cpus[node]) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+}
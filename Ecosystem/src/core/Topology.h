@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+
+namespace Ecosystem {
+
+    // Noeuds NUMA de la machine et leurs coeurs (Linux : /sys/devices/system/node).
+    // Ailleurs, ou si l'information manque, un seul noeud avec tous les coeurs.
+    class Topology {
+    public:
+        static const Topology& I() {
+            static const Topology inst;
+            return inst;
+        }
+
+        int nodes() const { return static_cast<int>(m_cpus.size()); }
+        const std::vector<int>& cpus(int node) const { return m_cpus[node]; }
+
+        // Noeud proprietaire de la ligne y d'une grille de height lignes : bandes
+        // egales et contigues, dans l'ordre des noeuds. Les domaines et le placement
+        // des pages d'une World utilisent le meme decoupage.
+        int nodeOfRow(int y, int height) const;
+
+        // Epingle le thread appelant sur les coeurs du noeud. false si la machine
+        // n'a qu'un noeud ou si le systeme refuse.
+        bool pinToNode(int node) const;
+
+    private:
+        Topology();
+
+        std::vector<std::vector<int>> m_cpus;
+    };
+}
@@ -0,0 +1,303 @@
+#include "DomainWorker.h"
+#include "core/Topology.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#if defined(ECOSYSTEM_HAS_SOCKET_TRANSPORT)
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace Ecosystem {
+
+    std::vector<std::pair<int, int>> DomainWorker::partition(int height, int ranks) {
+        std::vector<std::pair<int, int>> strips;
+        if (ranks <= 0 || height < ranks * kHaloRows) return strips;
+
+        for (int r = 0; r < ranks; ++r) {
+            strips.emplace_back(height * r / ranks, height * (r + 1) / ranks);
+        }
+        return strips;
+    }
+
+    static std::pair<int, int> ownedRows(const Config& cfg, const IHaloTransport& net) {
+        auto strips = DomainWorker::partition(cfg.height, net.size());
+        if (strips.empty()) {
+            throw std::invalid_argument("Grille trop basse pour ce nombre de domaines");
+        }
+        return strips[net.rank()];
+    }
+
+    DomainWorker::DomainWorker(Config& cfg, IHaloTransport& transport)
+        : net_(transport),
+        own0_(ownedRows(cfg, transport).first),
+        own1_(ownedRows(cfg, transport).second),
+        world_(cfg, own0_ - kHaloRows, own1_ + kHaloRows) {
+    }
+
+    void DomainWorker::step() {
+        std::int64_t allocsBefore = MemoryStats::I().totalAllocations();
+        world_.births_ = world_.deaths_ = world_.kills_ = 0;
+
+        // Les decisions ne lisent que l'etat du debut de tour : halo complet, puis en parallele.
+        exchangeHalo(kHaloRows);
+        world_.rebuildOccupancy();
+        world_.moves_.clear();
+        world_.decideMoves(own0_, own1_);
+        serialPhase([&](int) { world_.applyMoves(); return 0; });
+
+        exchangeHalo(1);
+        serialPhase([&](int) { world_.feedRows(own0_, own1_); return 0; });
+
+        exchangeHalo(1);
+        serialPhase([&](int) { world_.reproduceRows(own0_, own1_); return 0; });
+
+        if (world_.isSpreadTurn()) {
+            exchangeHalo(1);
+            world_.collectSpreadSources(own0_, own1_);
+            int total = sumOverRanks(world_.countPlants(own0_, own1_));
+            serialPhase([&](int count) { return world_.spreadPlants(count); }, total);
+        }
+
+        world_.turn_++;
+        world_.fireTimers(own0_, own1_);
+        world_.endFrame();
+
+        world_.allocationsLastTurn_ = MemoryStats::I().totalAllocations() - allocsBefore;
+    }
+
+    // Rangs pairs d'abord vers le bas, impairs d'abord vers le haut : chaque lien
+    // a un emetteur et un recepteur, meme si le transport bloque a l'envoi.
+    void DomainWorker::exchangeHalo(int rows) {
+        auto withDown = [&] {
+            if (!hasDown()) return;
+            buffer_.clear();
+            world_.encodeRows(own1_ - rows, own1_, buffer_);
+            net_.send(net_.rank() + 1, buffer_);
+            net_.receive(net_.rank() + 1, buffer_);
+            world_.decodeRows(buffer_.data(), buffer_.size());
+        };
+        auto withUp = [&] {
+            if (!hasUp()) return;
+            std::vector<std::uint8_t> incoming;
+            net_.receive(net_.rank() - 1, incoming);
+            buffer_.clear();
+            world_.encodeRows(own0_, own0_ + rows, buffer_);
+            net_.send(net_.rank() - 1, buffer_);
+            world_.decodeRows(incoming.data(), incoming.size());
+        };
+
+        if (net_.rank() % 2 == 0) {
+            withDown();
+            withUp();
+        }
+        else {
+            withUp();
+            withDown();
+        }
+    }
+
+    static void putCarry(std::vector<std::uint8_t>& out, int carry) {
+        std::int32_t v = carry;
+        out.resize(sizeof(v));
+        std::memcpy(out.data(), &v, sizeof(v));
+    }
+
+    static int getCarry(const std::vector<std::uint8_t>& in) {
+        std::int32_t v = 0;
+        std::memcpy(&v, in.data(), sizeof(v));
+        return v;
+    }
+
+    // Somme descendante le long de la chaine, puis diffusion du total en remontant.
+    int DomainWorker::sumOverRanks(int value) {
+        int sum = value;
+        if (hasUp()) {
+            net_.receive(net_.rank() - 1, buffer_);
+            sum += getCarry(buffer_);
+        }
+        if (hasDown()) {
+            putCarry(buffer_, sum);
+            net_.send(net_.rank() + 1, buffer_);
+            net_.receive(net_.rank() + 1, buffer_);
+            sum = getCarry(buffer_);
+        }
+        if (hasUp()) {
+            putCarry(buffer_, sum);
+            net_.send(net_.rank() - 1, buffer_);
+        }
+        return sum;
+    }
+
+    // Le rang r recoit la derniere ligne de r-1 et sa propre premiere ligne telles que
+    // r-1 les a laissees, travaille, renvoie la ligne de r-1 qu'il a pu modifier, puis
+    // passe la main a r+1 et attend que celui-ci lui rende sa derniere ligne.
+    template <class Fn>
+    int DomainWorker::serialPhase(Fn&& fn, int carry) {
+        if (hasUp()) {
+            net_.receive(net_.rank() - 1, buffer_);
+            carry = getCarry(buffer_);
+            world_.decodeRows(buffer_.data() + sizeof(std::int32_t), buffer_.size() - sizeof(std::int32_t));
+        }
+
+        carry = fn(carry);
+
+        if (hasUp()) {
+            buffer_.clear();
+            world_.encodeRows(own0_ - 1, own0_, buffer_);
+            net_.send(net_.rank() - 1, buffer_);
+        }
+        if (hasDown()) {
+            putCarry(buffer_, carry);
+            world_.encodeRows(own1_ - 1, own1_ + 1, buffer_);
+            net_.send(net_.rank() + 1, buffer_);
+            net_.receive(net_.rank() + 1, buffer_);
+            world_.decodeRows(buffer_.data(), buffer_.size());
+        }
+        return carry;
+    }
+
+    static std::vector<std::uint64_t> combineHashes(const std::vector<std::vector<std::uint64_t>>& perRank, int turns) {
+        std::vector<std::uint64_t> hashes(turns, 0);
+        for (auto const& rankHashes : perRank) {
+            for (int t = 0; t < turns && t < static_cast<int>(rankHashes.size()); ++t) {
+                hashes[t] ^= rankHashes[t];
+            }
+        }
+        return hashes;
+    }
+
+    static std::vector<std::uint64_t> runRank(Config& cfg, IHaloTransport& net, int turns) {
+        if (cfg.numa_placement) {
+            // Avant la World du domaine : ses pages suivent le thread (World::placeOnNodes).
+            auto rows = ownedRows(cfg, net);
+            Topology::I().pinToNode(Topology::I().nodeOfRow((rows.first + rows.second) / 2, cfg.height));
+        }
+        DomainWorker worker(cfg, net);
+        std::vector<std::uint64_t> hashes;
+        hashes.reserve(turns);
+        for (int t = 0; t < turns; ++t) {
+            worker.step();
+            hashes.push_back(worker.ownedHash());
+        }
+        return hashes;
+    }
+
+    static std::vector<std::uint64_t> runThreads(Config& cfg, int ranks, int turns) {
+        InProcessHub hub(ranks);
+        std::vector<std::vector<std::uint64_t>> perRank(ranks);
+        std::vector<std::thread> threads;
+        threads.reserve(ranks);
+
+        for (int r = 0; r < ranks; ++r) {
+            threads.emplace_back([&, r] {
+                InProcessTransport net(hub, r);
+                perRank[r] = runRank(cfg, net, turns);
+            });
+        }
+        for (auto& t : threads) t.join();
+
+        return combineHashes(perRank, turns);
+    }
+
+#if defined(ECOSYSTEM_HAS_SOCKET_TRANSPORT)
+
+    // Un processus par rang, relie a ses voisins par socketpair ; chaque rang
+    // renvoie ses hashes au parent par un tube une fois la simulation finie.
+    static std::vector<std::uint64_t> runProcesses(Config& cfg, int ranks, int turns) {
+        std::vector<std::array<int, 2>> links(ranks - 1);
+        for (auto& l : links) {
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, l.data()) != 0) {
+                throw std::runtime_error("socketpair impossible");
+            }
+        }
+
+        std::vector<int> results(ranks, -1);
+        std::vector<pid_t> children;
+
+        for (int r = 0; r < ranks; ++r) {
+            int pipeFds[2];
+            if (::pipe(pipeFds) != 0) throw std::runtime_error("pipe impossible");
+
+            pid_t pid = ::fork();
+            if (pid < 0) throw std::runtime_error("fork impossible");
+
+            if (pid == 0) {
+                ::close(pipeFds[0]);
+                for (int prev = 0; prev < r; ++prev) ::close(results[prev]);
+
+                int fdUp = -1, fdDown = -1;
+                for (int l = 0; l < ranks - 1; ++l) {
+                    if (l == r - 1) { fdUp = links[l][1]; ::close(links[l][0]); }
+                    else if (l == r) { fdDown = links[l][0]; ::close(links[l][1]); }
+                    else { ::close(links[l][0]); ::close(links[l][1]); }
+                }
+
+                int status = 0;
+                try {
+                    SocketTransport net(r, ranks, fdUp, fdDown);
+                    auto hashes = runRank(cfg, net, turns);
+                    const auto* p = reinterpret_cast<const char*>(hashes.data());
+                    std::size_t left = hashes.size() * sizeof(std::uint64_t);
+                    while (left > 0) {
+                        ssize_t w = ::write(pipeFds[1], p, left);
+                        if (w <= 0) { status = 1; break; }
+                        p += w;
+                        left -= static_cast<std::size_t>(w);
+                    }
+                }
+                catch (...) {
+                    status = 1;
+                }
+                ::_exit(status);
+            }
+
+            ::close(pipeFds[1]);
+            results[r] = pipeFds[0];
+            children.push_back(pid);
+        }
+
+        for (auto& l : links) {
+            ::close(l[0]);
+            ::close(l[1]);
+        }
+
+        std::vector<std::vector<std::uint64_t>> perRank(ranks);
+        for (int r = 0; r < ranks; ++r) {
+            perRank[r].resize(turns);
+            auto* p = reinterpret_cast<char*>(perRank[r].data());
+            std::size_t left = perRank[r].size() * sizeof(std::uint64_t);
+            while (left > 0) {
+                ssize_t n = ::read(results[r], p, left);
+                if (n <= 0) break;
+                p += n;
+                left -= static_cast<std::size_t>(n);
+            }
+            perRank[r].resize(turns - left / sizeof(std::uint64_t));
+            ::close(results[r]);
+        }
+
+        bool failed = false;
+        for (pid_t pid : children) {
+            int status = 0;
+            ::waitpid(pid, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed = true;
+        }
+        if (failed) throw std::runtime_error("Un domaine s'est arrete en erreur");
+
+        return combineHashes(perRank, turns);
+    }
+
+#endif
+
+    std::vector<std::uint64_t> runDistributed(Config& cfg, int ranks, int turns, TransportKind kind) {
+#if defined(ECOSYSTEM_HAS_SOCKET_TRANSPORT)
+        if (kind == TransportKind::Sockets) return runProcesses(cfg, ranks, turns);
+#endif
+        return runThreads(cfg, ranks, turns);
+    }
+}
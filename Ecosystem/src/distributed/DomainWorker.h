@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "../core/Config.h"
+#include "../world/World.h"
+#include "Transport.h"
+
+namespace Ecosystem {
+
+    // Un domaine = une bande horizontale de lignes de la grille globale,
+    // simulee par un rang. Les phases a effets de bord (deplacements appliques,
+    // nourrissage, reproduction, propagation) passent de rang en rang dans
+    // l'ordre des lignes, ce qui reproduit exactement le parcours d'un seul World.
+    class DomainWorker {
+    public:
+        // Portee de lecture maximale d'une strategie (recherche de proie, rayon 6).
+        static constexpr int kHaloRows = 6;
+
+        DomainWorker(Config& cfg, IHaloTransport& transport);
+
+        void step();
+
+        // Hash des lignes possedees ; le XOR sur tous les rangs vaut World::stateHash().
+        std::uint64_t ownedHash() const { return world_.hashRows(own0_, own1_); }
+        int ownBegin() const { return own0_; }
+        int ownEnd() const { return own1_; }
+
+        // Bandes [debut, fin) pour `ranks` domaines ; vide si la grille est trop basse.
+        static std::vector<std::pair<int, int>> partition(int height, int ranks);
+
+    private:
+        IHaloTransport& net_;
+        int own0_;
+        int own1_;
+        World world_;
+        std::vector<std::uint8_t> buffer_;
+
+        bool hasUp() const { return net_.rank() > 0; }
+        bool hasDown() const { return net_.rank() + 1 < net_.size(); }
+
+        void exchangeHalo(int rows);
+        int sumOverRanks(int value);
+        // Execute fn(carry) sur les lignes possedees une fois le rang precedent termine ;
+        // carry est transmis de rang en rang.
+        template <class Fn> int serialPhase(Fn&& fn, int carry = 0);
+    };
+
+    enum class TransportKind { Threads, Sockets };
+
+    // Simule `turns` tours sur `ranks` domaines et renvoie le hash global de chaque tour.
+    std::vector<std::uint64_t> runDistributed(Config& cfg, int ranks, int turns, TransportKind kind);
+}
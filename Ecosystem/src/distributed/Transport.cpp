@@ -0,0 +1,99 @@
+#include "Transport.h"
+#include <stdexcept>
+
+#if defined(ECOSYSTEM_HAS_SOCKET_TRANSPORT)
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Ecosystem {
+
+    InProcessHub::InProcessHub(int ranks) : m_ranks(ranks) {
+        m_boxes.reserve(static_cast<std::size_t>(ranks) * ranks);
+        for (int i = 0; i < ranks * ranks; ++i) {
+            m_boxes.push_back(std::make_unique<Mailbox>());
+        }
+    }
+
+    void InProcessHub::post(int from, int to, const std::vector<std::uint8_t>& msg) {
+        Mailbox& b = box(from, to);
+        {
+            std::lock_guard<std::mutex> lock(b.mutex);
+            b.queue.push_back(msg);
+        }
+        b.ready.notify_one();
+    }
+
+    void InProcessHub::take(int from, int to, std::vector<std::uint8_t>& msg) {
+        Mailbox& b = box(from, to);
+        std::unique_lock<std::mutex> lock(b.mutex);
+        b.ready.wait(lock, [&] { return !b.queue.empty(); });
+        msg = std::move(b.queue.front());
+        b.queue.pop_front();
+    }
+
+    void InProcessTransport::send(int peer, const std::vector<std::uint8_t>& msg) {
+        m_hub.post(m_rank, peer, msg);
+    }
+
+    void InProcessTransport::receive(int peer, std::vector<std::uint8_t>& msg) {
+        m_hub.take(peer, m_rank, msg);
+    }
+
+#if defined(ECOSYSTEM_HAS_SOCKET_TRANSPORT)
+
+    SocketTransport::SocketTransport(int rank, int size, int fdUp, int fdDown)
+        : m_rank(rank), m_size(size), m_fdUp(fdUp), m_fdDown(fdDown) {
+    }
+
+    SocketTransport::~SocketTransport() {
+        if (m_fdUp >= 0) ::close(m_fdUp);
+        if (m_fdDown >= 0) ::close(m_fdDown);
+    }
+
+    int SocketTransport::fdFor(int peer) const {
+        if (peer == m_rank - 1 && m_fdUp >= 0) return m_fdUp;
+        if (peer == m_rank + 1 && m_fdDown >= 0) return m_fdDown;
+        throw std::logic_error("SocketTransport : seuls les voisins directs sont relies");
+    }
+
+    static void writeAll(int fd, const void* data, std::size_t n) {
+        auto* p = static_cast<const std::uint8_t*>(data);
+        while (n > 0) {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) throw std::runtime_error("SocketTransport : echec d'ecriture");
+            p += w;
+            n -= static_cast<std::size_t>(w);
+        }
+    }
+
+    static void readAll(int fd, void* data, std::size_t n) {
+        auto* p = static_cast<std::uint8_t*>(data);
+        while (n > 0) {
+            ssize_t r = ::read(fd, p, n);
+            if (r < 0 && errno == EINTR) continue;
+            if (r <= 0) throw std::runtime_error("SocketTransport : connexion fermee");
+            p += r;
+            n -= static_cast<std::size_t>(r);
+        }
+    }
+
+    void SocketTransport::send(int peer, const std::vector<std::uint8_t>& msg) {
+        int fd = fdFor(peer);
+        std::uint64_t len = msg.size();
+        writeAll(fd, &len, sizeof(len));
+        writeAll(fd, msg.data(), msg.size());
+    }
+
+    void SocketTransport::receive(int peer, std::vector<std::uint8_t>& msg) {
+        int fd = fdFor(peer);
+        std::uint64_t len = 0;
+        readAll(fd, &len, sizeof(len));
+        msg.resize(static_cast<std::size_t>(len));
+        readAll(fd, msg.data(), msg.size());
+    }
+
+#endif
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Ecosystem {
+
+    // Canal de messages entre domaines voisins. Les messages arrivent dans
+    // l'ordre d'envoi pour une paire (emetteur, destinataire) donnee.
+    class IHaloTransport {
+    public:
+        virtual ~IHaloTransport() = default;
+
+        virtual int rank() const = 0;
+        virtual int size() const = 0;
+
+        virtual void send(int peer, const std::vector<std::uint8_t>& msg) = 0;
+        // Bloquant jusqu'a reception du prochain message de `peer`.
+        virtual void receive(int peer, std::vector<std::uint8_t>& msg) = 0;
+    };
+
+    // Boites aux lettres partagees entre threads d'un meme processus.
+    class InProcessHub {
+    public:
+        explicit InProcessHub(int ranks);
+
+        void post(int from, int to, const std::vector<std::uint8_t>& msg);
+        void take(int from, int to, std::vector<std::uint8_t>& msg);
+        int ranks() const { return m_ranks; }
+
+    private:
+        struct Mailbox {
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::deque<std::vector<std::uint8_t>> queue;
+        };
+
+        int m_ranks;
+        std::vector<std::unique_ptr<Mailbox>> m_boxes;
+
+        Mailbox& box(int from, int to) { return *m_boxes[from * m_ranks + to]; }
+    };
+
+    class InProcessTransport : public IHaloTransport {
+    public:
+        InProcessTransport(InProcessHub& hub, int rank) : m_hub(hub), m_rank(rank) {}
+
+        int rank() const override { return m_rank; }
+        int size() const override { return m_hub.ranks(); }
+
+        void send(int peer, const std::vector<std::uint8_t>& msg) override;
+        void receive(int peer, std::vector<std::uint8_t>& msg) override;
+
+    private:
+        InProcessHub& m_hub;
+        int m_rank;
+    };
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ECOSYSTEM_HAS_SOCKET_TRANSPORT 1
+
+    // Sockets Unix (socketpair) vers les voisins haut et bas d'une bande ;
+    // chaque message est prefixe par sa longueur sur 64 bits.
+    class SocketTransport : public IHaloTransport {
+    public:
+        SocketTransport(int rank, int size, int fdUp, int fdDown);
+        ~SocketTransport() override;
+
+        int rank() const override { return m_rank; }
+        int size() const override { return m_size; }
+
+        void send(int peer, const std::vector<std::uint8_t>& msg) override;
+        void receive(int peer, std::vector<std::uint8_t>& msg) override;
+
+    private:
+        int m_rank;
+        int m_size;
+        int m_fdUp;
+        int m_fdDown;
+
+        int fdFor(int peer) const;
+    };
+#endif
+}
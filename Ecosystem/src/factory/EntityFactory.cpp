@@ -3,16 +3,11 @@
 #include "model/Herbivore.h"
 #include "model/Carnivore.h"
 #include "core/Strategies.h"
-#include <cstdlib>
 
 namespace Ecosystem {
 
-    std::unique_ptr<IPlant> EntityFactory::makePlant() {
-        return std::make_unique<Plant>();
-    }
-
-    static Gender randomGender() {
-        return (std::rand() % 2 == 0 ? Gender::Male : Gender::Female);
+    std::unique_ptr<IPlant> EntityFactory::makePlant(int bornAt) {
+        return std::make_unique<Plant>(bornAt);
     }
 
     std::unique_ptr<IAnimal> EntityFactory::makeHerbivore(Gender g) {
@@ -24,10 +19,6 @@ namespace Ecosystem {
         );
     }
 
-    std::unique_ptr<IAnimal> EntityFactory::makeHerbivore() {
-        return makeHerbivore(randomGender());
-    }
-
     std::unique_ptr<IAnimal> EntityFactory::makeCarnivore(Gender g) {
         return std::make_unique<Carnivore>(
             AnimalKind::Carnivore,
@@ -37,7 +28,14 @@ namespace Ecosystem {
         );
     }
 
-    std::unique_ptr<IAnimal> EntityFactory::makeCarnivore() {
-        return makeCarnivore(randomGender());
+    std::unique_ptr<IPlant> EntityFactory::clone(const IPlant& p) {
+        if (auto* plant = dynamic_cast<const Plant*>(&p)) return std::make_unique<Plant>(*plant);
+        return makePlant();
+    }
+
+    std::unique_ptr<IAnimal> EntityFactory::clone(IAnimal& a) {
+        auto copy = a.kind() == AnimalKind::Herbivore ? makeHerbivore(a.gender()) : makeCarnivore(a.gender());
+        copy->timers() = a.timers();
+        return copy;
     }
 }
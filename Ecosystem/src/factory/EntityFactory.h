@@ -7,12 +7,15 @@ namespace Ecosystem {
     struct IAnimal;
 
     struct EntityFactory {
-        static std::unique_ptr<IPlant>  makePlant();
-
-		static std::unique_ptr<IAnimal> makeHerbivore();
-		static std::unique_ptr<IAnimal> makeCarnivore();
+        // Nee au tour bornAt.
+        static std::unique_ptr<IPlant>  makePlant(int bornAt = 0);
 
+		// Le sexe vient toujours de l'appelant, tire sur le generateur du monde.
 		static std::unique_ptr<IAnimal> makeHerbivore(Gender g);
 		static std::unique_ptr<IAnimal> makeCarnivore(Gender g);
+
+		// Meme espece, meme etat.
+		static std::unique_ptr<IPlant> clone(const IPlant& p);
+		static std::unique_ptr<IAnimal> clone(IAnimal& a);
     };
 }
@@ -0,0 +1,68 @@
+#include "FramePublisher.h"
+#include <algorithm>
+#include "world/World.h"
+
+namespace Ecosystem {
+
+    static CellCode codeOf(const Cell& c, int turn) {
+        if (c.animal) {
+            auto& a = *c.animal;
+            bool baby = a.timers().babyTurns(turn) > 0;
+            bool male = a.gender() == Gender::Male;
+            int base = (a.kind() == AnimalKind::Herbivore)
+                ? static_cast<int>(CellCode::HerbMale)
+                : static_cast<int>(CellCode::CarnMale);
+            return static_cast<CellCode>(base + (baby ? 2 : 0) + (male ? 0 : 1));
+        }
+        return c.plant ? CellCode::Plant : CellCode::Empty;
+    }
+
+    FramePublisher::FramePublisher(const World& world, const std::string& name, int slots) {
+        int width = world.cfg().width;
+        int height = world.rowEnd() - world.rowBegin();
+        if (!m_region.create(name, FrameRing::bytesFor(width, height, slots))) return;
+
+        m_ring = FrameRing(m_region.data());
+        m_ring.init(width, height, slots);
+    }
+
+    FramePublisher::~FramePublisher() {
+        if (isOpen()) m_ring.header().closed.store(1, std::memory_order_release);
+    }
+
+    bool FramePublisher::due() const {
+        Clock::duration period = std::max<Clock::duration>(kMinPeriod, m_lastCost * kCostFactor);
+        return Clock::now() - m_lastStart >= period;
+    }
+
+    void FramePublisher::publish(const World& world) {
+        if (!hasReader()) return;
+        m_lastStart = Clock::now();
+
+        // Totaux de la pyramide d'apercu : la tuile du dernier niveau couvre le monde.
+        const OverviewPyramid& overview = world.overview();
+        const TileCounts& total = overview.at(overview.levels() - 1, 0, 0);
+        FrameStats stats{ world.turn(), total.plants, total.herbivores, total.carnivores, total.babies };
+
+        std::uint8_t* out = m_ring.beginWrite(stats);
+        int width = world.cfg().width;
+        std::size_t i = 0;
+        std::uint8_t pending = 0;
+
+        for (int y = world.rowBegin(); y < world.rowEnd(); ++y) {
+            for (int x = 0; x < width; ++x, ++i) {
+                auto code = static_cast<std::uint8_t>(codeOf(*world.getCell(x, y), world.turn()));
+                if (i & 1) {
+                    out[i / 2] = static_cast<std::uint8_t>(pending | (code << 4));
+                }
+                else {
+                    pending = code;
+                }
+            }
+        }
+        if (i & 1) out[i / 2] = pending;
+
+        m_ring.commit();
+        m_lastCost = Clock::now() - m_lastStart;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include "FrameRing.h"
+#include "SharedMemory.h"
+
+namespace Ecosystem {
+
+    class World;
+
+    // Publie une trame par tour dans un segment partage pour EcosystemViewer.
+    // Ne bloque jamais : un visualiseur lent voit ses trames ecrasees ; sans
+    // visualiseur attache (FrameRing::readerAttached), publish ne fait rien.
+    class FramePublisher {
+    public:
+        // Ecart minimal entre deux debuts de trame en cours de tour (~30 images/s),
+        // allonge a kCostFactor fois le cout de la derniere trame sur les grands mondes.
+        static constexpr std::chrono::milliseconds kMinPeriod{ 33 };
+        static constexpr int kCostFactor = 5;
+
+        FramePublisher(const World& world, const std::string& name, int slots = 4);
+        ~FramePublisher();
+
+        FramePublisher(const FramePublisher&) = delete;
+        FramePublisher& operator=(const FramePublisher&) = delete;
+
+        bool isOpen() const { return m_region.isOpen(); }
+        bool hasReader() const { return isOpen() && m_ring.readerAttached(); }
+        // true si une trame en cours de tour peut partir (voir kMinPeriod).
+        bool due() const;
+        void publish(const World& world);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        SharedMemoryRegion m_region;
+        FrameRing m_ring{ nullptr };
+        Clock::time_point m_lastStart{};
+        Clock::duration m_lastCost{};
+    };
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace Ecosystem {
+
+    // Codes de cellule d'une trame, 4 bits chacun (deux cellules par octet).
+    enum class CellCode : std::uint8_t {
+        Empty,
+        Plant,
+        HerbMale,
+        HerbFemale,
+        HerbBabyMale,
+        HerbBabyFemale,
+        CarnMale,
+        CarnFemale,
+        CarnBabyMale,
+        CarnBabyFemale,
+        Count
+    };
+
+    // Memes caracteres que World::print, dans l'ordre de CellCode.
+    inline constexpr char kCellCodeChars[] = ".*hHmfcCMF";
+
+    // Comptes d'une trame, tires des totaux tenus a jour par le monde (sans parcours).
+    struct FrameStats {
+        std::int32_t turn = 0;
+        std::int32_t plants = 0;
+        std::int32_t herbivores = 0;
+        std::int32_t carnivores = 0;
+        std::int32_t babies = 0;
+    };
+
+    inline CellCode packedCode(const std::uint8_t* cells, std::size_t i) {
+        std::uint8_t b = cells[i / 2];
+        return static_cast<CellCode>((i & 1) ? (b >> 4) : (b & 0x0F));
+    }
+
+    // Anneau de trames dans un segment partage : un seul ecrivain qui ne
+    // s'arrete jamais, des lecteurs qui recopient une trame et la valident par
+    // le numero de sequence de son emplacement (pair = complete). Un lecteur
+    // trop lent est double par l'ecrivain et recommence avec la trame suivante.
+    // Les lecteurs signalent leur presence (readerHeartbeat) : sans lecteur recent,
+    // l'ecrivain ne remplit aucune trame.
+    class FrameRing {
+    public:
+        static constexpr std::uint32_t kMagic = 0x56434545; // "EECV"
+        static constexpr std::uint32_t kVersion = 2;
+
+        struct Header {
+            std::uint32_t magic;
+            std::uint32_t version;
+            std::int32_t width;
+            std::int32_t height;
+            std::uint32_t slotCount;
+            std::uint32_t reserved;
+            std::uint64_t slotBytes;
+            // Nombre de trames publiees ; la derniere est la n-1.
+            std::atomic<std::uint64_t> published;
+            std::atomic<std::uint32_t> closed;
+            // Dernier passage d'un lecteur, en ms d'horloge monotone (commune aux
+            // processus de la machine) ; 0 = jamais.
+            std::atomic<std::uint64_t> readerHeartbeat;
+        };
+
+        // Sans signe de vie pendant ce delai, le lecteur est considere parti.
+        static constexpr std::chrono::milliseconds kReaderTimeout{ 1000 };
+
+        struct SlotHeader {
+            std::atomic<std::uint64_t> sequence;
+            FrameStats stats;
+        };
+
+        static_assert(std::is_trivially_copyable_v<FrameStats>);
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+        static std::size_t packedBytes(int width, int height) {
+            return (static_cast<std::size_t>(width) * height + 1) / 2;
+        }
+
+        static std::size_t slotBytesFor(int width, int height) {
+            return align(sizeof(SlotHeader) + packedBytes(width, height));
+        }
+
+        static std::size_t bytesFor(int width, int height, int slots) {
+            return align(sizeof(Header)) + slotBytesFor(width, height) * slots;
+        }
+
+        explicit FrameRing(void* base) : m_base(static_cast<std::uint8_t*>(base)) {}
+
+        Header& header() const { return *reinterpret_cast<Header*>(m_base); }
+
+        void init(int width, int height, int slots) {
+            Header& h = *new (m_base) Header{};
+            h.magic = kMagic;
+            h.version = kVersion;
+            h.width = width;
+            h.height = height;
+            h.slotCount = static_cast<std::uint32_t>(slots);
+            h.slotBytes = slotBytesFor(width, height);
+            for (int s = 0; s < slots; ++s) {
+                new (slotAt(s)) SlotHeader{};
+            }
+            h.closed.store(0, std::memory_order_relaxed);
+            h.readerHeartbeat.store(0, std::memory_order_relaxed);
+            h.published.store(0, std::memory_order_release);
+        }
+
+        // Verifie un segment ouvert par un lecteur avant de s'y fier.
+        bool valid(std::size_t mappedBytes) const {
+            if (mappedBytes < sizeof(Header)) return false;
+            const Header& h = header();
+            return h.magic == kMagic && h.version == kVersion && h.slotCount > 0
+                && h.width > 0 && h.height > 0
+                && mappedBytes >= bytesFor(h.width, h.height, static_cast<int>(h.slotCount));
+        }
+
+        static std::uint64_t nowMillis() {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // Cote lecteur, a chaque passage, qu'une trame soit lue ou non.
+        void touchReader() const {
+            header().readerHeartbeat.store(nowMillis(), std::memory_order_relaxed);
+        }
+
+        bool readerAttached() const {
+            std::uint64_t seen = header().readerHeartbeat.load(std::memory_order_relaxed);
+            return seen != 0 && seen + static_cast<std::uint64_t>(kReaderTimeout.count()) > nowMillis();
+        }
+
+        // Emplacement de la prochaine trame, a remplir puis valider par commit().
+        std::uint8_t* beginWrite(const FrameStats& stats) {
+            Header& h = header();
+            std::uint64_t n = h.published.load(std::memory_order_relaxed);
+            SlotHeader& s = *slotAt(static_cast<int>(n % h.slotCount));
+            s.sequence.store(2 * n + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            s.stats = stats;
+            return cellsOf(s);
+        }
+
+        void commit() {
+            Header& h = header();
+            std::uint64_t n = h.published.load(std::memory_order_relaxed);
+            slotAt(static_cast<int>(n % h.slotCount))->sequence.store(2 * n + 2, std::memory_order_release);
+            h.published.store(n + 1, std::memory_order_release);
+        }
+
+        // Copie la derniere trame complete ; faux si aucune n'est encore disponible.
+        bool readLatest(FrameStats& stats, std::uint8_t* cells, std::uint64_t& frame) const {
+            const Header& h = header();
+            std::size_t bytes = packedBytes(h.width, h.height);
+
+            for (int attempt = 0; attempt < 16; ++attempt) {
+                std::uint64_t count = h.published.load(std::memory_order_acquire);
+                if (count == 0) return false;
+
+                std::uint64_t n = count - 1;
+                SlotHeader& s = *slotAt(static_cast<int>(n % h.slotCount));
+                std::uint64_t before = s.sequence.load(std::memory_order_acquire);
+                if (before != 2 * n + 2) continue;
+
+                stats = s.stats;
+                std::memcpy(cells, cellsOf(s), bytes);
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (s.sequence.load(std::memory_order_relaxed) == before) {
+                    frame = n;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::uint8_t* m_base;
+
+        static std::size_t align(std::size_t n) { return (n + 63) & ~std::size_t(63); }
+
+        SlotHeader* slotAt(int s) const {
+            return reinterpret_cast<SlotHeader*>(m_base + align(sizeof(Header)) + header().slotBytes * s);
+        }
+
+        static std::uint8_t* cellsOf(SlotHeader& s) {
+            return reinterpret_cast<std::uint8_t*>(&s) + sizeof(SlotHeader);
+        }
+    };
+}
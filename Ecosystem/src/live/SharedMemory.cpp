@@ -0,0 +1,133 @@
+#include "SharedMemory.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Ecosystem {
+
+    SharedMemoryRegion::~SharedMemoryRegion() {
+        close();
+    }
+
+#ifdef _WIN32
+
+    static std::string mappingName(const std::string& name) {
+        return "Local\\" + name;
+    }
+
+    bool SharedMemoryRegion::create(const std::string& name, std::size_t bytes) {
+        close();
+        auto size = static_cast<unsigned long long>(bytes);
+        HANDLE h = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+            static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFFu), mappingName(name).c_str());
+        if (!h) return false;
+
+        void* p = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+        if (!p) {
+            CloseHandle(h);
+            return false;
+        }
+        m_handle = h;
+        m_data = p;
+        m_size = bytes;
+        m_name = name;
+        m_owner = true;
+        return true;
+    }
+
+    bool SharedMemoryRegion::open(const std::string& name) {
+        close();
+        HANDLE h = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mappingName(name).c_str());
+        if (!h) return false;
+
+        void* p = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if (!p) {
+            CloseHandle(h);
+            return false;
+        }
+        MEMORY_BASIC_INFORMATION info{};
+        VirtualQuery(p, &info, sizeof(info));
+
+        m_handle = h;
+        m_data = p;
+        m_size = info.RegionSize;
+        m_name = name;
+        m_owner = false;
+        return true;
+    }
+
+    void SharedMemoryRegion::close() {
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_handle) CloseHandle(m_handle);
+        m_data = nullptr;
+        m_handle = nullptr;
+        m_size = 0;
+        m_owner = false;
+    }
+
+#else
+
+    static std::string shmName(const std::string& name) {
+        return "/" + name;
+    }
+
+    bool SharedMemoryRegion::create(const std::string& name, std::size_t bytes) {
+        close();
+        int fd = ::shm_open(shmName(name).c_str(), O_CREAT | O_RDWR, 0600);
+        if (fd < 0) return false;
+
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        m_data = p;
+        m_size = bytes;
+        m_name = name;
+        m_owner = true;
+        return true;
+    }
+
+    bool SharedMemoryRegion::open(const std::string& name) {
+        close();
+        int fd = ::shm_open(shmName(name).c_str(), O_RDWR, 0600);
+        if (fd < 0) return false;
+
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        m_data = p;
+        m_size = static_cast<std::size_t>(st.st_size);
+        m_name = name;
+        m_owner = false;
+        return true;
+    }
+
+    void SharedMemoryRegion::close() {
+        if (m_data) {
+            ::munmap(m_data, m_size);
+            if (m_owner) ::shm_unlink(shmName(m_name).c_str());
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_owner = false;
+    }
+
+#endif
+}
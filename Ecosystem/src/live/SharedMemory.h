@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace Ecosystem {
+
+    // Segment de memoire partagee nomme (shm_open / CreateFileMapping).
+    // Le createur le detruit a la fin ; les lecteurs ne font que s'y attacher.
+    class SharedMemoryRegion {
+    public:
+        SharedMemoryRegion() = default;
+        ~SharedMemoryRegion();
+
+        SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+        SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+        bool create(const std::string& name, std::size_t bytes);
+        bool open(const std::string& name);
+        void close();
+
+        bool isOpen() const { return m_data != nullptr; }
+        void* data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+
+    private:
+        std::string m_name;
+        void* m_data = nullptr;
+        std::size_t m_size = 0;
+        bool m_owner = false;
+#ifdef _WIN32
+        void* m_handle = nullptr;
+#endif
+    };
+}
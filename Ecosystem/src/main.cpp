@@ -1,5 +1,11 @@
 #include "core/Config.h"
 #include "world/World.h"
+#include "distributed/DomainWorker.h"
+#include "live/FramePublisher.h"
+#include "world/ClusterAnalysis.h"
+#include "world/HabitatMap.h"
+#include "core/PerfCounters.h"
+#include "bench/Benchmarks.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -9,15 +15,12 @@
 #include <fstream>
 #include <iomanip>
 #include <sstream>
+#include <memory>
+#include <cctype>
+#include <cstdio>
+#include <algorithm>
 
-std::ofstream createLogFile() {
-    namespace fs = std::filesystem;
-
-    fs::path resultsDir = fs::current_path() / "results";
-    if (!fs::exists(resultsDir)) {
-        fs::create_directory(resultsDir);
-    }
-
+std::string runStamp() {
     auto t = std::time(nullptr);
     std::tm tm{};
 #ifdef _WIN32
@@ -27,9 +30,26 @@ std::ofstream createLogFile() {
 #endif
 
     std::ostringstream oss;
-    oss << "run_"
-        << std::put_time(&tm, "%Y-%m-%d_%H-%M-%S")
-        << ".txt";
+    oss << "run_" << std::put_time(&tm, "%Y-%m-%d_%H-%M-%S");
+    return oss.str();
+}
+
+std::filesystem::path resultsDirectory() {
+    namespace fs = std::filesystem;
+
+    fs::path resultsDir = fs::current_path() / "results";
+    if (!fs::exists(resultsDir)) {
+        fs::create_directory(resultsDir);
+    }
+    return resultsDir;
+}
+
+std::ofstream createLogFile(const std::string& stamp) {
+    namespace fs = std::filesystem;
+
+    fs::path resultsDir = resultsDirectory();
+    std::ostringstream oss;
+    oss << stamp << ".txt";
 
     fs::path logPath = resultsDir / oss.str();
     std::ofstream logFile(logPath);
@@ -44,31 +64,298 @@ std::ofstream createLogFile() {
     return logFile;
 }
 
-int main() {
+struct RunOptions {
+    bool headless = false;
+    int turns = 1000;
+    bool printHashes = false;
+    bool verifyHash = false;
+    bool fused = false;
+    std::string metricsPath;
+    int domains = 0;
+    bool socketTransport = true;
+    std::string liveName;
+    Ecosystem::GridLayout layout = Ecosystem::GridLayout::RowMajor;
+    bool perf = false;
+    std::string mappedDir;
+    bool hugePages = false;
+    bool numa = false;
+    Ecosystem::BenchOptions bench;
+    bool lod = false;
+    Ecosystem::LodOptions lodOptions;
+    bool view = false;
+    Ecosystem::World::View viewWindow;
+    std::string habitatMap;
+    int clusterInterval = 0;
+    int followX = 10;
+    int followY = 10;
+};
+
+RunOptions parseOptions(int argc, char** argv) {
+    RunOptions opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            opt.headless = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                opt.turns = std::atoi(argv[++i]);
+            }
+        }
+        else if (arg == "--hashes") opt.printHashes = true;
+        else if (arg == "--verify-hash") opt.verifyHash = true;
+        else if (arg == "--fused") opt.fused = true;
+        else if (arg == "--perf") opt.perf = true;
+        else if (arg == "--mapped" && i + 1 < argc) opt.mappedDir = argv[++i];
+        else if (arg == "--huge-pages") opt.hugePages = true;
+        else if (arg == "--map" && i + 1 < argc) opt.habitatMap = argv[++i];
+        else if (arg == "--clusters" && i + 1 < argc) opt.clusterInterval = std::atoi(argv[++i]);
+        else if (arg == "--numa") opt.numa = true;
+        else if (arg == "--metrics" && i + 1 < argc) opt.metricsPath = argv[++i];
+        else if (arg == "--distributed" && i + 1 < argc) opt.domains = std::atoi(argv[++i]);
+        else if (arg == "--live") {
+            opt.liveName = "ecosystem";
+            if (i + 1 < argc && argv[i + 1][0] != '-') opt.liveName = argv[++i];
+        }
+        else if (arg == "--layout" && i + 1 < argc) {
+            std::string name = argv[++i];
+            opt.layout = name == "tiled" ? Ecosystem::GridLayout::Tiled
+                : name == "padded" ? Ecosystem::GridLayout::Padded : Ecosystem::GridLayout::RowMajor;
+        }
+        else if (arg == "--bench") {
+            opt.bench.name = "?";
+            if (i + 1 < argc && argv[i + 1][0] != '-') opt.bench.name = argv[++i];
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) opt.bench.size = std::atoi(argv[++i]);
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) opt.bench.turns = std::atoi(argv[++i]);
+        }
+        else if (arg == "--lod" && i + 1 < argc) {
+            // Region d'interet x0,y0,x1,y1 ; le reste du monde passe au modele agrege.
+            auto& l = opt.lodOptions;
+            opt.lod = std::sscanf(argv[++i], "%d,%d,%d,%d", &l.roiX0, &l.roiY0, &l.roiX1, &l.roiY1) == 4;
+        }
+        else if (arg == "--view" && i + 1 < argc) {
+            // Fenetre x,y,zoom de l'affichage interactif.
+            auto& v = opt.viewWindow;
+            opt.view = std::sscanf(argv[++i], "%d,%d,%d", &v.x, &v.y, &v.zoom) == 3;
+        }
+        else if (arg == "--follow" && i + 1 < argc) {
+            // Individu suivi par l'affichage interactif : le premier animal a partir de x,y.
+            std::sscanf(argv[++i], "%d,%d", &opt.followX, &opt.followY);
+        }
+        else if (arg == "--transport" && i + 1 < argc) opt.socketTransport = std::string(argv[++i]) != "threads";
+    }
+    return opt;
+}
+
+// Premier animal a partir de (x, y) dans l'ordre de la grille ; seul parcours de
+// la grille du suivi, ensuite l'individu est retrouve par sa poignee.
+Ecosystem::World::AnimalHandle firstAnimalFrom(const Ecosystem::World& world, int width, int height, int x, int y) {
+    for (int i = std::max(0, y * width + x); i < width * height; ++i) {
+        auto h = world.handleAt(i % width, i / width);
+        if (h.valid()) return h;
+    }
+    return {};
+}
+
+// Avec un visualiseur attache, les longs tours sont decoupes en tranches de
+// kLiveFrame et publies en cours de route quand FramePublisher::due le permet, puis
+// une fois a la fin du tour. Sans visualiseur, tour entier et aucune trame.
+constexpr std::chrono::milliseconds kLiveFrame(16);
+
+void advanceTurn(Ecosystem::World& world, Ecosystem::FramePublisher* live) {
+    if (!live || !live->hasReader()) {
+        world.step();
+        return;
+    }
+    while (!world.stepFor(kLiveFrame)) {
+        if (live->due()) live->publish(world);
+    }
+    live->publish(world);
+}
+
+int runHeadless(Ecosystem::World& world, const RunOptions& opt, Ecosystem::FramePublisher* live) {
+    using namespace Ecosystem;
+
+    std::unique_ptr<MetricsRecorder> metrics;
+    if (!opt.metricsPath.empty()) {
+        metrics = std::make_unique<MetricsRecorder>(opt.metricsPath);
+        if (!metrics->isOpen()) {
+            std::cerr << "  Impossible d'ouvrir les fichiers de metriques : " << opt.metricsPath << "\n";
+            return 1;
+        }
+    }
+
+    // Groupes (composantes connexes) tous les clusterInterval tours : a cote des
+    // metriques s'il y en a, sinon sur la console.
+    ClusterAnalysis clusters;
+    std::ofstream clusterCsv;
+    if (opt.clusterInterval > 0 && metrics) {
+        clusterCsv.open(opt.metricsPath + "_clusters.csv", std::ios::binary);
+        ClusterAnalysis::writeCsvHeader(clusterCsv);
+    }
+
+    for (int t = 0; t < opt.turns; ++t) {
+        advanceTurn(world, live);
+        if (metrics) metrics->record(world.metrics());
+        if (opt.clusterInterval > 0 && (t + 1) % opt.clusterInterval == 0) {
+            ClusterReport r = clusters.analyze(world);
+            if (clusterCsv.is_open()) ClusterAnalysis::writeCsv(clusterCsv, t + 1, r);
+            else std::cout << "Groupes au tour " << (t + 1) << " : " << ClusterAnalysis::summary(r) << "\n";
+        }
+        if (opt.perf) std::cout << PerfCounters::I().turnLine(t + 1) << "\n";
+        if (opt.printHashes) {
+            std::cout << (t + 1) << ' ' << std::hex << std::setw(16) << std::setfill('0')
+                << world.stateHash() << std::dec << std::setfill(' ') << "\n";
+        }
+    }
+    if (metrics) metrics->flush();
+
+    std::cout << world.statsLine(opt.turns) << "\n\n";
+    std::cout << world.memorySummary();
+    if (opt.perf) std::cout << "\n" << PerfCounters::I().summary();
+    return 0;
+}
+
+// Meme graine en un seul processus et en domaines ; compare les hashes tour par tour.
+int runDistributedCheck(Ecosystem::World& world, const RunOptions& opt) {
     using namespace Ecosystem;
 
     auto& cfg = Config::I();
-    World world(cfg);
+    if (DomainWorker::partition(cfg.height, opt.domains).empty()) {
+        std::cerr << "  Grille trop basse pour " << opt.domains << " domaines (minimum "
+            << DomainWorker::kHaloRows << " lignes chacun)\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::uint64_t> hashes;
+    try {
+        hashes = runDistributed(cfg, opt.domains, opt.turns,
+            opt.socketTransport ? TransportKind::Sockets : TransportKind::Threads);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "  Simulation distribuee interrompue : " << e.what() << "\n";
+        return 1;
+    }
+    auto distributedTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    int firstMismatch = -1;
+    for (int t = 0; t < opt.turns; ++t) {
+        world.step();
+        if (firstMismatch < 0 && (t >= static_cast<int>(hashes.size()) || hashes[t] != world.stateHash())) {
+            firstMismatch = t + 1;
+        }
+    }
+    auto singleTime = std::chrono::steady_clock::now() - start;
+
+    using ms = std::chrono::milliseconds;
+    std::cout << world.statsLine(opt.turns) << "\n";
+    std::cout << " Domaines : " << opt.domains << " (" << (opt.socketTransport ? "sockets" : "threads") << ") "
+        << std::chrono::duration_cast<ms>(distributedTime).count() << " ms, un seul processus "
+        << std::chrono::duration_cast<ms>(singleTime).count() << " ms\n";
+
+    if (firstMismatch >= 0) {
+        std::cout << " Divergence au tour " << firstMismatch << "\n";
+        return 1;
+    }
+    std::cout << " Resultats identiques sur " << opt.turns << " tours\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    using namespace Ecosystem;
+
+    RunOptions opt = parseOptions(argc, argv);
 
-    std::ofstream log = createLogFile();
+    auto& cfg = Config::I();
+    cfg.verify_state_hash = opt.verifyHash;
+    cfg.fused_step = opt.fused;
+    cfg.mapped_storage_dir = opt.mappedDir;
+    cfg.huge_pages = opt.hugePages;
+    cfg.numa_placement = opt.numa;
+    if (!opt.habitatMap.empty()) {
+        // La grille prend les dimensions de l'image.
+        if (!HabitatMap::readSize(opt.habitatMap, cfg.width, cfg.height)) {
+            std::cerr << "  Carte d'habitat illisible : " << opt.habitatMap << "\n";
+            return 1;
+        }
+        cfg.habitat_map = opt.habitatMap;
+    }
+
+    if (opt.perf && !PerfCounters::I().enable()) {
+        std::cerr << "  Compteurs materiels indisponibles (" << PerfCounters::I().unavailableReason()
+            << ") : seul le temps sera mesure\n";
+    }
+    if (!opt.bench.name.empty()) {
+        if (opt.bench.name == "?") {
+            std::cout << "Bancs disponibles :\n" << benchmarkList();
+            return 0;
+        }
+        return runBenchmark(cfg, opt.bench);
+    }
+
+    // Les domaines parcourent leurs bandes ligne par ligne : la reference aussi.
+    World world(cfg, opt.domains > 0 ? GridLayout::RowMajor : opt.layout);
+    if (opt.lod && opt.domains == 0) world.enableLevelOfDetail(opt.lodOptions);
+
+    if (opt.domains > 0) {
+        return runDistributedCheck(world, opt);
+    }
+
+    // Visualisation en direct : EcosystemViewer s'attache au segment quand il veut.
+    std::unique_ptr<FramePublisher> live;
+    if (!opt.liveName.empty()) {
+        live = std::make_unique<FramePublisher>(world, opt.liveName);
+        if (!live->isOpen()) {
+            std::cerr << "  Impossible de creer le segment partage : " << opt.liveName << "\n";
+            live.reset();
+        }
+        else {
+            live->publish(world);
+        }
+    }
+
+    if (opt.headless) {
+        return runHeadless(world, opt, live.get());
+    }
+
+    std::string stamp = runStamp();
+    std::ofstream log = createLogFile(stamp);
     if (!log.is_open()) return 1;
 
+    MetricsRecorder metrics((resultsDirectory() / (stamp + "_metrics")).string());
+    ClusterAnalysis clusters;
+
     const int maxTurns = 30;
-    int dbgX = 10;
-    int dbgY = 10;
+    int dbgX = opt.followX;
+    int dbgY = opt.followY;
+    World::AnimalHandle followed = firstAnimalFrom(world, cfg.width, cfg.height, dbgX, dbgY);
+
+    // Au-dela de 200 colonnes la grille entiere est illisible : apercu du monde entier.
+    bool useView = opt.view || cfg.width > 200;
+    World::View view = opt.viewWindow;
+    if (!opt.view) {
+        view.zoom = std::max((cfg.width + view.columns - 1) / view.columns, (cfg.height + view.rows - 1) / view.rows);
+    }
 
     for (int t = 0; t < maxTurns; ++t) {
         system("cls");
         std::ostringstream frame;
         frame << world.statsLine(t) << "\n";
+        if (opt.clusterInterval > 0 && t % opt.clusterInterval == 0) {
+            frame << "Groupes : " << ClusterAnalysis::summary(clusters.analyze(world)) << "\n";
+        }
         std::cout << frame.str();
         log << frame.str();
 
+        // A sa mort, on reste sur sa derniere cellule.
+        bool alive = world.find(followed, &dbgX, &dbgY) != nullptr;
+
         std::ostringstream grid;
         {
             std::stringstream buf;
             std::streambuf* oldCout = std::cout.rdbuf(buf.rdbuf());
-            world.print(dbgX, dbgY);
+            if (useView) world.printView(view);
+            else world.print(dbgX, dbgY);
             std::cout.rdbuf(oldCout);
             grid << buf.str();
         }
@@ -80,6 +367,7 @@ int main() {
         {
             std::stringstream buf;
             std::streambuf* oldCout = std::cout.rdbuf(buf.rdbuf());
+            if (followed.valid() && !alive) std::cout << "Individu suivi mort\n";
             world.debugPrintCell(dbgX, dbgY);
             std::cout.rdbuf(oldCout);
             dbg << buf.str();
@@ -88,11 +376,18 @@ int main() {
         std::cout << dbg.str();
         log << dbg.str();
 
-        world.step();
+        advanceTurn(world, live.get());
+        metrics.record(world.metrics());
+        if (opt.perf) log << PerfCounters::I().turnLine(t + 1) << "\n";
 
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 
+    std::cout << "\n" << world.memorySummary();
+    if (opt.perf) {
+        std::cout << "\n" << PerfCounters::I().summary();
+        log << "\n" << PerfCounters::I().summary();
+    }
     std::cout << "\n Simulation termine. Rsultats enregistrs.\n";
     return 0;
 }
@@ -21,24 +21,12 @@ namespace Ecosystem {
         return m_gender;
     }
 
-    bool Animal::is_Hungry() const  {
-        return m_hunger;
+    AnimalTimers& Animal::timers()  {
+        return m_timers;
     }
 
-    int& Animal::hungery_ref()  {
-        return m_hunger;
-    }
-
-    int& Animal::satiety_ref()  {
-        return m_satiety;
-    }
-
-    int& Animal::repro_cooldown_ref()  {
-        return m_repro_cooldown;
-    }
-
-    int& Animal::baby_turns_ref()  {
-        return m_baby_turns;
+    const AnimalTimers& Animal::timers() const  {
+        return m_timers;
     }
 
     IMovementStrategy& Animal::movement()  {
@@ -49,16 +37,4 @@ namespace Ecosystem {
         return *m_feeding_strategy;
     }
 
-    void Animal::on_step_begin() {
-        if (m_satiety > 0) {
-            m_satiety--;
-        }
-        else {
-            m_hunger++;
-        }
-        if (m_repro_cooldown > 0) {
-            m_repro_cooldown--;
-        }
-    }
-
 }
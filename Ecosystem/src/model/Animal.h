@@ -1,5 +1,6 @@
 #pragma once
 #include "core/Interfaces.h"
+#include "core/MemoryStats.h"
 #include <memory>
 
 namespace Ecosystem {
@@ -7,7 +8,7 @@ namespace Ecosystem {
     class IMovementStrategy;
     class IFeedingStrategy;
 
-    class Animal : public IAnimal {
+    class Animal : public IAnimal, public TrackedAlloc<MemCategory::Animals> {
     public:
         Animal(AnimalKind k,
             Gender g,
@@ -20,17 +21,9 @@ namespace Ecosystem {
 
         Gender gender() const override;
 
-        void on_step_begin() override;
+        AnimalTimers& timers() override;
 
-        bool is_Hungry() const override;
-
-        int& hungery_ref() override;
-
-        int& satiety_ref() override;
-
-        int& repro_cooldown_ref() override;
-
-        int& baby_turns_ref() override;
+        const AnimalTimers& timers() const override;
 
         IMovementStrategy& movement() override;
 
@@ -40,10 +33,7 @@ namespace Ecosystem {
         AnimalKind m_kind;
         Gender     m_gender;
 
-        int m_hunger = 0;
-        int m_satiety = 0;
-        int m_repro_cooldown = 0;
-        int m_baby_turns = 0;
+        AnimalTimers m_timers;
 
         std::unique_ptr<IMovementStrategy> m_movement_strategy;
         std::unique_ptr<IFeedingStrategy>  m_feeding_strategy;
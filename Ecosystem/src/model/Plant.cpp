@@ -1,12 +1,11 @@
 #include "Plant.h"
 
 namespace Ecosystem {
-	void Plant::age_one_trun() {
-			m_age++;
+	Plant::Plant(int bornAt) : m_bornAt(bornAt) {
 		}
 
-		int Plant::age() const {
-			return m_age;
+		int Plant::age(int turn) const {
+			return turn - m_bornAt;
 		}
 
 		std::string Plant::name() const {
@@ -1,16 +1,17 @@
 #pragma once
 #include "core/Interfaces.h"
+#include "core/MemoryStats.h"
 
 namespace Ecosystem {
-	class Plant : public IPlant {
+	class Plant : public IPlant, public TrackedAlloc<MemCategory::Plants> {
 	public:
-		void age_one_trun() override;
+		explicit Plant(int bornAt = 0);
 
-		int age() const;
+		int age(int turn) const override;
 
 		std::string name() const override;
 
 	private:
-		int m_age = 0;
+		int m_bornAt = 0;
 	};
 }
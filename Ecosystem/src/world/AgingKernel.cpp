@@ -0,0 +1,141 @@
+#include "AgingKernel.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ECOSYSTEM_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC accepte les intrinseques AVX2 dans toute fonction.
+#define ECOSYSTEM_AVX2
+#else
+#define ECOSYSTEM_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace Ecosystem {
+
+    static_assert(AgingColumns::kLanes == 16, "une voie par octet d'un registre de 128 bits");
+
+    // Une cellule ; renvoie les voies affamees. SSE2 fait partie de x86-64.
+    static std::uint16_t ageLanes(std::uint8_t* sat, std::uint8_t* hun, std::uint8_t* cd,
+        std::uint8_t* baby, const std::uint8_t* limit) {
+#if defined(ECOSYSTEM_X86)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi8(1);
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sat));
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hun));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cd));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(baby));
+
+        // Le masque vaut -1 : le soustraire incremente la faim.
+        h = _mm_sub_epi8(h, _mm_cmpeq_epi8(s, zero));
+        s = _mm_subs_epu8(s, one);
+        c = _mm_subs_epu8(c, one);
+        b = _mm_subs_epu8(b, one);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sat), s);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(hun), h);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(cd), c);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(baby), b);
+
+        __m128i lim = _mm_loadu_si128(reinterpret_cast<const __m128i*>(limit));
+        return static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(h, lim), h)));
+#else
+        std::uint16_t starving = 0;
+        for (int l = 0; l < AgingColumns::kLanes; ++l) {
+            if (sat[l] > 0) sat[l]--;
+            else hun[l]++;
+            if (cd[l] > 0) cd[l]--;
+            if (baby[l] > 0) baby[l]--;
+            starving |= hun[l] >= limit[l] ? static_cast<std::uint16_t>(1u << l) : 0;
+        }
+        return starving;
+#endif
+    }
+
+    static void ageScalar(const AgingColumns& c, std::size_t first, std::size_t last, std::uint16_t* starving) {
+        for (std::size_t i = first; i < last; ++i) {
+            std::size_t k = i * AgingColumns::kLanes;
+            starving[i] = ageLanes(c.satiety + k, c.hunger + k, c.cooldown + k, c.baby + k, c.starvationLimit);
+        }
+    }
+
+#if defined(ECOSYSTEM_X86)
+    ECOSYSTEM_AVX2 static void ageAvx2(const AgingColumns& c, std::size_t cells, std::uint16_t* starving) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi8(1);
+        const __m256i lim = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.starvationLimit)));
+
+        std::size_t i = 0;
+        for (; i + 2 <= cells; i += 2) {
+            std::size_t k = i * AgingColumns::kLanes;
+            auto* sp = reinterpret_cast<__m256i*>(c.satiety + k);
+            auto* hp = reinterpret_cast<__m256i*>(c.hunger + k);
+            auto* cp = reinterpret_cast<__m256i*>(c.cooldown + k);
+            auto* bp = reinterpret_cast<__m256i*>(c.baby + k);
+            __m256i s = _mm256_loadu_si256(sp);
+            __m256i h = _mm256_loadu_si256(hp);
+
+            h = _mm256_sub_epi8(h, _mm256_cmpeq_epi8(s, zero));
+            _mm256_storeu_si256(sp, _mm256_subs_epu8(s, one));
+            _mm256_storeu_si256(hp, h);
+            _mm256_storeu_si256(cp, _mm256_subs_epu8(_mm256_loadu_si256(cp), one));
+            _mm256_storeu_si256(bp, _mm256_subs_epu8(_mm256_loadu_si256(bp), one));
+
+            auto m = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(h, lim), h)));
+            starving[i] = static_cast<std::uint16_t>(m);
+            starving[i + 1] = static_cast<std::uint16_t>(m >> 16);
+        }
+        ageScalar(c, i, cells, starving);
+    }
+
+    static bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+        int r[4];
+        __cpuid(r, 0);
+        if (r[0] < 7) return false;
+        // AVX et registres YMM sauvegardes par le systeme (OSXSAVE, XCR0).
+        __cpuid(r, 1);
+        if (!(r[2] & (1 << 27)) || !(r[2] & (1 << 28))) return false;
+        if ((_xgetbv(0) & 6) != 6) return false;
+        __cpuidex(r, 7, 0);
+        return (r[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+    bool agingKernelAvailable(AgingKernel k) {
+        switch (k) {
+        case AgingKernel::Scalar:
+            return true;
+        case AgingKernel::Avx2:
+#if defined(ECOSYSTEM_X86)
+            {
+                static const bool has = cpuHasAvx2();
+                return has;
+            }
+#else
+            return false;
+#endif
+        }
+        return false;
+    }
+
+    AgingKernel bestAgingKernel() {
+        return agingKernelAvailable(AgingKernel::Avx2) ? AgingKernel::Avx2 : AgingKernel::Scalar;
+    }
+
+    const char* agingKernelName(AgingKernel k) {
+        return k == AgingKernel::Avx2 ? "avx2" : "scalaire";
+    }
+
+    void ageCells(AgingKernel k, const AgingColumns& c, std::size_t cells, std::uint16_t* starving) {
+#if defined(ECOSYSTEM_X86)
+        if (k == AgingKernel::Avx2 && agingKernelAvailable(k)) return ageAvx2(c, cells, starving);
+#endif
+        ageScalar(c, 0, cells, starving);
+    }
+}
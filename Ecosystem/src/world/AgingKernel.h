@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Ecosystem {
+
+    // Compteurs d'animaux empaquetes [cellule][voie], 16 voies d'un octet par cellule
+    // (voir Ensemble). Les voies sans animal sont decomptees aussi : toute arrivee
+    // recrit ses compteurs.
+    struct AgingColumns {
+        static constexpr int kLanes = 16;
+
+        std::uint8_t* satiety;
+        std::uint8_t* hunger;
+        std::uint8_t* cooldown;
+        std::uint8_t* baby;
+        const std::uint8_t* starvationLimit; // kLanes octets
+    };
+
+    // Scalar : une voie a la fois (SSE2 si le compilateur le vise, une cellule par registre).
+    // Avx2 : deux cellules par registre, compile quel que soit le reste du programme et
+    // choisi a l'execution si le processeur l'a.
+    enum class AgingKernel : std::uint8_t { Scalar, Avx2 };
+
+    bool agingKernelAvailable(AgingKernel k);
+    // Avx2 s'il est disponible, sinon Scalar ; determine une fois.
+    AgingKernel bestAgingKernel();
+    const char* agingKernelName(AgingKernel k);
+
+    // Une passe sur les cellules [0, cells) : satiete--, sinon faim++ ; cooldown-- ;
+    // baby-- ; starving[i] recoit les voies de la cellule i dont la faim atteint la limite.
+    void ageCells(AgingKernel k, const AgingColumns& c, std::size_t cells, std::uint16_t* starving);
+}
@@ -0,0 +1,10 @@
+#include "Cell.h"
+#include "factory/EntityFactory.h"
+
+namespace Ecosystem {
+
+	void cloneInto(Cell& dst, const Cell& src) {
+		dst.plant = src.plant ? EntityFactory::clone(*src.plant) : nullptr;
+		dst.animal = src.animal ? EntityFactory::clone(*src.animal) : nullptr;
+	}
+}
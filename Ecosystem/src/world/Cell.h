@@ -8,4 +8,7 @@ namespace Ecosystem {
 		std::unique_ptr<IPlant> plant;
 		std::unique_ptr<IAnimal> animal;
 	};
+
+	// Copie profonde de la plante et de l'animal (pages partagees entre mondes).
+	void cloneInto(Cell& dst, const Cell& src);
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "ClusterAnalysis.h"
+#include "World.h"
+#include "core/Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <sstream>
+
+namespace Ecosystem {
+
+    enum LayerBits : std::uint8_t {
+        PlantBit = 1,
+        HerbivoreBit = 2,
+        CarnivoreBit = 4
+    };
+
+    void ClusterStats::add(int size) {
+        components++;
+        cells += size;
+        largest = std::max(largest, size);
+        if (size == 1) isolated++;
+        histogram[std::min(kBuckets - 1, static_cast<int>(std::bit_width(static_cast<unsigned>(size))) - 1)]++;
+    }
+
+    void ClusterStats::merge(const ClusterStats& other) {
+        components += other.components;
+        cells += other.cells;
+        largest = std::max(largest, other.largest);
+        isolated += other.isolated;
+        for (int k = 0; k < kBuckets; ++k) histogram[k] += other.histogram[k];
+    }
+
+    ClusterReport ClusterAnalysis::analyze(const World& world) {
+        m_width = world.cfg().width;
+        m_height = world.rowEnd() - world.rowBegin();
+        const auto n = static_cast<std::size_t>(m_width) * m_height;
+        m_layers.resize(n);
+        m_parent.resize(n);
+        m_size.resize(n);
+
+        const int y0 = world.rowBegin();
+        parallelFor(static_cast<std::size_t>(m_height), kBandRows, [&](std::size_t begin, std::size_t end) {
+            for (int y = static_cast<int>(begin); y < static_cast<int>(end); ++y) {
+                std::size_t i = static_cast<std::size_t>(y) * m_width;
+                for (int x = 0; x < m_width; ++x, ++i) {
+                    const Cell& c = *world.getCell(x, y + y0);
+                    std::uint8_t bits = c.plant ? PlantBit : 0;
+                    if (c.animal) bits |= c.animal->kind() == AnimalKind::Herbivore ? HerbivoreBit : CarnivoreBit;
+                    m_layers[i] = bits;
+                }
+            }
+        });
+
+        ClusterReport out{};
+        label(PlantBit, out);
+        // Un seul animal par cellule : herbivores et carnivores en une passe.
+        label(HerbivoreBit | CarnivoreBit, out);
+        return out;
+    }
+
+    // Moitie du chemin a chaque pas.
+    std::int32_t ClusterAnalysis::find(std::int32_t i) {
+        while (m_parent[i] != i) {
+            m_parent[i] = m_parent[m_parent[i]];
+            i = m_parent[i];
+        }
+        return i;
+    }
+
+    // Sans ecriture : sur toutes les bandes a la fois une fois les unions faites.
+    std::int32_t ClusterAnalysis::root(std::int32_t i) const {
+        while (m_parent[i] != i) i = m_parent[i];
+        return i;
+    }
+
+    // La plus petite racine l'emporte : etiquettes independantes du decoupage.
+    void ClusterAnalysis::unite(std::int32_t a, std::int32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (a > b) std::swap(a, b);
+        m_parent[b] = a;
+    }
+
+    void ClusterAnalysis::label(std::uint8_t mask, ClusterReport& out) {
+        const int w = m_width;
+        auto key = [&](std::int32_t i) { return static_cast<std::uint8_t>(m_layers[i] & mask); };
+        auto band = [&](std::size_t b, auto&& fn) {
+            int yEnd = std::min(m_height, static_cast<int>(b + 1) * kBandRows);
+            for (int y = static_cast<int>(b) * kBandRows; y < yEnd; ++y) fn(y);
+        };
+
+        // Unions dans chaque bande : les racines restent dans la bande, pas de course.
+        parallelFor(static_cast<std::size_t>(bands()), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t b = begin; b < end; ++b) {
+                const int top = static_cast<int>(b) * kBandRows;
+                band(b, [&](int y) {
+                    std::int32_t i = y * w;
+                    for (int x = 0; x < w; ++x, ++i) {
+                        m_parent[i] = i;
+                        m_size[i] = 0;
+                        std::uint8_t k = key(i);
+                        if (!k) continue;
+                        if (x > 0 && key(i - 1) == k) unite(i - 1, i);
+                        if (y > top && key(i - w) == k) unite(i - w, i);
+                    }
+                });
+            }
+        });
+
+        // Raccord des bandes : une ligne de paires par bord.
+        for (int b = 1; b < bands(); ++b) {
+            std::int32_t i = b * kBandRows * w;
+            for (int x = 0; x < w; ++x, ++i) {
+                std::uint8_t k = key(i);
+                if (k && key(i - w) == k) unite(i - w, i);
+            }
+        }
+
+        parallelFor(static_cast<std::size_t>(bands()), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t b = begin; b < end; ++b) {
+                band(b, [&](int y) {
+                    std::int32_t i = y * w;
+                    for (int x = 0; x < w; ++x, ++i) {
+                        if (key(i)) std::atomic_ref<std::int32_t>(m_size[root(i)]).fetch_add(1, std::memory_order_relaxed);
+                    }
+                });
+            }
+        });
+
+        std::mutex merged;
+        parallelFor(static_cast<std::size_t>(bands()), 1, [&](std::size_t begin, std::size_t end) {
+            ClusterReport local{};
+            for (std::size_t b = begin; b < end; ++b) {
+                band(b, [&](int y) {
+                    std::int32_t i = y * w;
+                    for (int x = 0; x < w; ++x, ++i) {
+                        std::uint8_t k = key(i);
+                        if (!k || m_parent[i] != i) continue;
+                        auto layer = k == PlantBit ? OccupancyLayer::Plants
+                            : k == HerbivoreBit ? OccupancyLayer::Herbivores : OccupancyLayer::Carnivores;
+                        local[static_cast<std::size_t>(layer)].add(m_size[i]);
+                    }
+                });
+            }
+            std::lock_guard lock(merged);
+            for (std::size_t l = 0; l < out.size(); ++l) out[l].merge(local[l]);
+        });
+    }
+
+    static const char* const kLayerNames[] = { "plants", "herbivores", "carnivores" };
+
+    void ClusterAnalysis::writeCsvHeader(std::ostream& out) {
+        out << "turn,layer,components,cells,largest,isolated";
+        for (int k = 0; k < ClusterStats::kBuckets; ++k) out << ",size_" << (1u << k);
+        out << '\n';
+    }
+
+    void ClusterAnalysis::writeCsv(std::ostream& out, int turn, const ClusterReport& r) {
+        for (std::size_t l = 0; l < r.size(); ++l) {
+            const ClusterStats& s = r[l];
+            out << turn << ',' << kLayerNames[l] << ',' << s.components << ',' << s.cells << ','
+                << s.largest << ',' << s.isolated;
+            for (int h : s.histogram) out << ',' << h;
+            out << '\n';
+        }
+    }
+
+    std::string ClusterAnalysis::summary(const ClusterReport& r) {
+        static const char* const kLabels[] = { "massifs", "troupeaux", "meutes" };
+        std::ostringstream out;
+        out.setf(std::ios::fixed);
+        out.precision(1);
+        for (std::size_t l = 0; l < r.size(); ++l) {
+            const ClusterStats& s = r[l];
+            if (l) out << " | ";
+            out << kLabels[l] << "=" << s.components << " (moy " << s.meanSize() << ", max " << s.largest
+                << ", isoles " << s.isolated << ")";
+        }
+        return out.str();
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "core/MemoryStats.h"
+#include "OccupancyTable.h"
+
+namespace Ecosystem {
+
+    class World;
+
+    // Composantes connexes (4-voisinage) d'une couche : nombre, cellules couvertes,
+    // plus grande, isolees (taille 1) et histogramme par puissances de 2 (case k :
+    // tailles [2^k, 2^(k+1))).
+    struct ClusterStats {
+        static constexpr int kBuckets = 24;
+        int components = 0;
+        int cells = 0;
+        int largest = 0;
+        int isolated = 0;
+        std::array<int, kBuckets> histogram{};
+
+        double meanSize() const { return components > 0 ? static_cast<double>(cells) / components : 0.0; }
+        void add(int size);
+        void merge(const ClusterStats& other);
+    };
+
+    // Une entree par OccupancyLayer : massifs de plantes, troupeaux d'herbivores,
+    // meutes de carnivores.
+    using ClusterReport = std::array<ClusterStats, 3>;
+
+    // Union-find en parallele sur des bandes de kBandRows lignes : chaque bande
+    // etiquette ses cellules sans sortir de ses lignes, les bandes sont ensuite
+    // raccordees a leurs bords, puis tailles et histogrammes sont comptes par bande.
+    // Les tables restent allouees d'une analyse a l'autre. Seules les cellules
+    // simulees en detail comptent (voir World::enableLevelOfDetail).
+    class ClusterAnalysis {
+    public:
+        static constexpr int kBandRows = 64;
+
+        ClusterReport analyze(const World& world);
+
+        // CSV, une ligne par couche : turn, layer, components, cells, largest,
+        // isolated, puis size_1, size_2, size_4... (bornes basses des cases).
+        static void writeCsvHeader(std::ostream& out);
+        static void writeCsv(std::ostream& out, int turn, const ClusterReport& r);
+        // Resume sur une ligne, pour la console.
+        static std::string summary(const ClusterReport& r);
+
+    private:
+        template <class T>
+        using Table = std::vector<T, TrackingAllocator<T, MemCategory::Scratch>>;
+
+        int m_width = 0;
+        int m_height = 0;
+        // Par cellule : bit 0 plante, bit 1 herbivore, bit 2 carnivore.
+        Table<std::uint8_t> m_layers;
+        Table<std::int32_t> m_parent;
+        Table<std::int32_t> m_size;
+
+        int bands() const { return (m_height + kBandRows - 1) / kBandRows; }
+        std::int32_t find(std::int32_t i);
+        std::int32_t root(std::int32_t i) const;
+        void unite(std::int32_t a, std::int32_t b);
+        // Composantes des cellules de meme cle (m_layers & mask non nul).
+        void label(std::uint8_t mask, ClusterReport& out);
+    };
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "core/MappedStorage.h"
+
+namespace Ecosystem {
+
+    // Taille de page qui fait 2 Mo, une page enorme quand l'allocateur en demande.
+    template <class T>
+    constexpr int hugePageBits() {
+        return std::max(1, static_cast<int>(std::bit_width(kHugePageBytes / sizeof(T))) - 1);
+    }
+
+    // Tableau decoupe en pages partagees en copie sur ecriture. Copier le tableau ne
+    // copie que les pointeurs de pages ; une page partagee est dupliquee au premier
+    // acces non const de l'un de ses proprietaires. Les lectures pures doivent donc
+    // passer par la version const. Les elements non copiables sont dupliques par
+    // cloneInto(dst, src), trouve par ADL.
+    template <class T, MemCategory C, int PageBits = 16>
+    class CowPages {
+    public:
+        using Allocator = CellAllocator<T, C>;
+        static constexpr std::size_t kPageSize = std::size_t(1) << PageBits;
+
+        explicit CowPages(const Allocator& alloc = Allocator()) : m_alloc(alloc) {}
+
+        // Partage toutes les pages : aucune des deux copies n'en est plus seule proprietaire.
+        CowPages(const CowPages& o) : m_alloc(o.m_alloc), m_size(o.m_size), m_slots(o.m_slots) {
+            for (auto& s : m_slots) s.owned = false;
+            for (auto& s : o.m_slots) s.owned = false;
+        }
+        CowPages& operator=(const CowPages&) = delete;
+        CowPages(CowPages&&) noexcept = default;
+        CowPages& operator=(CowPages&&) noexcept = default;
+
+        const Allocator& get_allocator() const { return m_alloc; }
+        std::size_t size() const { return m_size; }
+
+        // Pages neuves : elements construits par defaut, ou tous egaux a v.
+        void resize(std::size_t n) { reset(n, nullptr); }
+        void assign(std::size_t n, const T& v) { reset(n, &v); }
+
+        const T& operator[](std::size_t i) const {
+            return m_slots[i >> PageBits].data[i & kMask];
+        }
+        T& operator[](std::size_t i) {
+            Slot& s = m_slots[i >> PageBits];
+            if (!s.owned) own(s);
+            return s.data[i & kMask];
+        }
+
+        std::size_t pageCount() const { return m_slots.size(); }
+        // Pages encore partagees avec un autre tableau.
+        std::size_t sharedPages() const {
+            std::size_t n = 0;
+            for (auto const& s : m_slots) n += s.page.use_count() > 1 ? 1 : 0;
+            return n;
+        }
+
+        // Conseil de residence sur les elements [first, last), page par page.
+        void advise(std::size_t first, std::size_t last, Residency r) const {
+            forEachSpan(first, last, [r](T* p, std::size_t n) { adviseMapped(p, n * sizeof(T), r); });
+        }
+
+        // Premier acces aux elements [first, last) depuis le thread appelant, qui
+        // place ainsi leurs pages neuves sur son noeud (voir touchPages).
+        void touch(std::size_t first, std::size_t last) {
+            forEachSpan(first, last, [](T* p, std::size_t n) { touchPages(p, n * sizeof(T)); });
+        }
+
+        // Octets presents dans le cache de pages ; -1 si inconnu.
+        std::int64_t residentBytes() const {
+            std::int64_t total = 0;
+            for (auto const& s : m_slots) {
+                std::int64_t b = Ecosystem::residentBytes(s.data, s.page->size() * sizeof(T));
+                if (b < 0) return -1;
+                total += b;
+            }
+            return total;
+        }
+
+    private:
+        static constexpr std::size_t kMask = kPageSize - 1;
+        using Page = std::vector<T, Allocator>;
+
+        struct Slot {
+            T* data = nullptr;
+            bool owned = true;
+            std::shared_ptr<Page> page;
+        };
+
+        Allocator m_alloc;
+        std::size_t m_size = 0;
+        // Les drapeaux owned d'un tableau copie changent aussi : voir le constructeur de copie.
+        mutable std::vector<Slot> m_slots;
+
+        void reset(std::size_t n, const T* v) {
+            m_slots.clear();
+            m_size = n;
+            for (std::size_t first = 0; first < n; first += kPageSize) {
+                std::size_t length = std::min(kPageSize, n - first);
+                std::shared_ptr<Page> page;
+                if constexpr (std::is_copy_constructible_v<T>) {
+                    page = v ? std::make_shared<Page>(length, *v, m_alloc) : std::make_shared<Page>(length, m_alloc);
+                }
+                else {
+                    page = std::make_shared<Page>(length, m_alloc);
+                }
+                m_slots.push_back({ page->data(), true, std::move(page) });
+            }
+        }
+
+        template <class Fn>
+        void forEachSpan(std::size_t first, std::size_t last, Fn&& fn) const {
+            for (std::size_t k = first >> PageBits; k < m_slots.size() && (k << PageBits) < last; ++k) {
+                std::size_t begin = std::max(first, k << PageBits);
+                std::size_t end = std::min({ last, (k + 1) << PageBits, m_size });
+                if (end > begin) fn(m_slots[k].data + (begin & kMask), end - begin);
+            }
+        }
+
+        void own(Slot& s) {
+            if (s.page.use_count() > 1) {
+                auto copy = std::make_shared<Page>(m_alloc);
+                if constexpr (std::is_copy_assignable_v<T>) {
+                    copy->assign(s.page->begin(), s.page->end());
+                }
+                else {
+                    copy->resize(s.page->size());
+                    for (std::size_t k = 0; k < copy->size(); ++k) cloneInto((*copy)[k], (*s.page)[k]);
+                }
+                s.page = std::move(copy);
+                s.data = s.page->data();
+            }
+            s.owned = true;
+        }
+    };
+}
@@ -0,0 +1,496 @@
+#include "Ensemble.h"
+#include "World.h"
+#include "StateHash.h"
+#include "AgingKernel.h"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Ecosystem {
+
+    static_assert(Ensemble::kLanes == 16, "une voie par octet d'un registre de 128 bits");
+
+    // Directions de Strategies.cpp et World.cpp, dans le meme ordre ; kStay : sur place.
+    static constexpr std::array<std::array<int, 2>, 4> kDirs{ { {1, 0}, {-1, 0}, {0, 1}, {0, -1} } };
+    static constexpr int kStay = 4;
+
+    template <class Fn>
+    static void forEachLane(Ensemble::LaneMask m, Fn&& fn) {
+        while (m) {
+            fn(std::countr_zero(m));
+            m &= m - 1;
+        }
+    }
+
+    static Ensemble::LaneMask bit(int lane) {
+        return static_cast<Ensemble::LaneMask>(1u << lane);
+    }
+
+    // Voies dont l'octet vaut zero.
+    static Ensemble::LaneMask zeroLanes(const std::uint8_t* p) {
+#if defined(__SSE2__)
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return static_cast<Ensemble::LaneMask>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())));
+#else
+        Ensemble::LaneMask m = 0;
+        for (int l = 0; l < Ensemble::kLanes; ++l) m |= p[l] == 0 ? bit(l) : 0;
+        return m;
+#endif
+    }
+
+    static std::uint8_t laneCounter(int value, const char* name) {
+        if (value < 0 || value > 255) {
+            throw std::invalid_argument(std::string("ensemble : ") + name + " doit tenir dans [0, 255]");
+        }
+        return static_cast<std::uint8_t>(value);
+    }
+
+    Ensemble::Ensemble(const std::vector<Config>& lanes) : m_configs(lanes) {
+        if (m_configs.empty() || m_configs.size() > static_cast<std::size_t>(kLanes)) {
+            throw std::invalid_argument("ensemble : de 1 a 16 configurations");
+        }
+        m_lanes = static_cast<int>(m_configs.size());
+        m_width = m_configs[0].width;
+        m_height = m_configs[0].height;
+
+        for (int l = 0; l < m_lanes; ++l) {
+            const Config& cfg = m_configs[l];
+            if (cfg.width != m_width || cfg.height != m_height) {
+                throw std::invalid_argument("ensemble : toutes les voies doivent avoir les memes dimensions");
+            }
+            // Pas de cases infranchissables dans les masques des voies.
+            if (!cfg.habitat_map.empty()) {
+                throw std::invalid_argument("ensemble : les cartes d'habitat ne sont pas prises en charge");
+            }
+            m_satietyAfterEat[l] = laneCounter(cfg.satiety_after_eat, "satiety_after_eat");
+            m_starvationLimit[l] = laneCounter(cfg.starvation_limit, "starvation_limit");
+            m_reproCooldown[l] = laneCounter(cfg.repro_cool_down, "repro_cool_down");
+            // +1 : le vieillissement du tour de naissance decompte deja un tour.
+            m_babyTurns[l] = laneCounter(cfg.baby_stay_turns + 1, "baby_stay_turns + 1");
+            if (cfg.repro_cool_down > 0) m_cooldownLanes |= bit(l);
+        }
+
+        std::size_t cells = static_cast<std::size_t>(m_width) * m_height;
+        for (auto* c : { &m_plant, &m_animal, &m_carnivore, &m_female, &m_ready, &m_sources }) c->assign(cells, 0);
+        for (auto& c : m_moves) c.assign(cells, 0);
+        for (auto* c : { &m_satiety, &m_hunger, &m_cooldown, &m_baby }) c->assign(cells * kLanes, 0);
+
+        for (int l = 0; l < m_lanes; ++l) importLane(l);
+        buildNearest();
+    }
+
+    // Le tirage initial est celui de World : on construit le monde et on recopie ses cellules.
+    void Ensemble::importLane(int lane) {
+        World world(m_configs[lane]);
+        LaneMask b = bit(lane);
+
+        for (int y = 0; y < m_height; ++y) {
+            for (int x = 0; x < m_width; ++x) {
+                const Cell* c = world.getCell(x, y);
+                int i = cellIndex(x, y);
+                if (c->plant) {
+                    m_plant[i] |= b;
+                    m_plants[lane]++;
+                }
+                if (!c->animal) continue;
+
+                IAnimal& a = *c->animal;
+                m_animal[i] |= b;
+                if (a.kind() == AnimalKind::Carnivore) m_carnivore[i] |= b;
+                if (a.gender() == Gender::Female) m_female[i] |= b;
+                std::size_t k = static_cast<std::size_t>(i) * kLanes + lane;
+                const AnimalTimers& t = a.timers();
+                m_satiety[k] = static_cast<std::uint8_t>(t.satiety(world.turn()));
+                m_hunger[k] = static_cast<std::uint8_t>(t.hunger(world.turn()));
+                m_cooldown[k] = static_cast<std::uint8_t>(t.cooldown(world.turn()));
+                m_baby[k] = static_cast<std::uint8_t>(t.babyTurns(world.turn()));
+            }
+        }
+    }
+
+    // Pas de step_towards (Strategies.cpp) : d'abord en x, puis en y.
+    static int stepTowards(int dx, int dy) {
+        if (dx > 0) return 0;
+        if (dx < 0) return 1;
+        if (dy > 0) return 2;
+        if (dy < 0) return 3;
+        return kStay;
+    }
+
+    void Ensemble::buildNearest() {
+        for (int r = 1; r < static_cast<int>(m_nearest.size()); ++r) {
+            auto& offsets = m_nearest[r];
+            for (int dy = -r; dy <= r; ++dy)
+                for (int dx = -r; dx <= r; ++dx)
+                    offsets.push_back({ dx, dy, stepTowards(dx, dy) });
+            std::stable_sort(offsets.begin(), offsets.end(), [](const Offset& a, const Offset& b) {
+                return std::abs(a.dx) + std::abs(a.dy) < std::abs(b.dx) + std::abs(b.dy);
+            });
+        }
+    }
+
+    // Pour chaque voie de lanes, la cible la plus proche dans le carre de rayon radius ;
+    // target(c) donne les voies ou la cellule c est une cible. Renvoie les voies servies.
+    template <class Target>
+    Ensemble::LaneMask Ensemble::nearest(int x, int y, int radius, LaneMask lanes, Target&& target,
+        std::array<const Offset*, kLanes>& hit) const {
+        LaneMask found = 0;
+        if (!lanes) return found;
+        for (const Offset& o : m_nearest[radius]) {
+            int nx = x + o.dx;
+            int ny = y + o.dy;
+            if (!inBounds(nx, ny)) continue;
+            LaneMask h = static_cast<LaneMask>(target(cellIndex(nx, ny)) & lanes & ~found);
+            if (!h) continue;
+            found |= h;
+            forEachLane(h, [&](int l) { hit[l] = &o; });
+            if (found == lanes) break;
+        }
+        return found;
+    }
+
+    void Ensemble::feed(int cell, int lane) {
+        std::size_t k = static_cast<std::size_t>(cell) * kLanes + lane;
+        m_satiety[k] = m_satietyAfterEat[lane];
+        m_hunger[k] = 0;
+    }
+
+    void Ensemble::removeAnimals(int cell, LaneMask m) {
+        m_animal[cell] &= ~m;
+        m_carnivore[cell] &= ~m;
+        m_female[cell] &= ~m;
+        m_ready[cell] &= ~m;
+    }
+
+    void Ensemble::moveAnimals(int from, int to, LaneMask m) {
+        m_animal[to] |= m;
+        m_carnivore[to] |= m_carnivore[from] & m;
+        m_female[to] |= m_female[from] & m;
+        removeAnimals(from, m);
+
+        forEachLane(m, [&](int l) {
+            std::size_t src = static_cast<std::size_t>(from) * kLanes + l;
+            std::size_t dst = static_cast<std::size_t>(to) * kLanes + l;
+            m_satiety[dst] = m_satiety[src];
+            m_hunger[dst] = m_hunger[src];
+            m_cooldown[dst] = m_cooldown[src];
+            m_baby[dst] = m_baby[src];
+        });
+    }
+
+    void Ensemble::refreshReady() {
+        for (std::size_t i = 0; i < m_animal.size(); ++i) {
+            m_ready[i] = m_animal[i] ? static_cast<LaneMask>(m_animal[i] & zeroLanes(&m_cooldown[i * kLanes])) : 0;
+        }
+    }
+
+    // Deplacements : SmartHerbivoreMove et SmartCarnivoreMove sur l'etat du debut de tour.
+
+    void Ensemble::decideMoves() {
+        for (auto& m : m_moves) std::fill(m.begin(), m.end(), 0);
+        refreshReady();
+
+        std::array<const Offset*, kLanes> hit{};
+        Lanes dir{};
+
+        auto plants = [&](int c) { return m_plant[c]; };
+        auto carnivores = [&](int c) { return static_cast<LaneMask>(m_animal[c] & m_carnivore[c]); };
+        auto herbivores = [&](int c) { return static_cast<LaneMask>(m_animal[c] & ~m_carnivore[c]); };
+
+        for (int y = 0; y < m_height; ++y) {
+            for (int x = 0; x < m_width; ++x) {
+                int i = cellIndex(x, y);
+                if (!m_animal[i]) continue;
+
+                // Les bebes ne bougent pas.
+                LaneMask mobile = m_animal[i] & zeroLanes(&m_baby[static_cast<std::size_t>(i) * kLanes]);
+                if (!mobile) continue;
+
+                LaneMask female = m_female[i];
+                auto mates = [&](LaneMask kind) {
+                    return [&, kind](int c) {
+                        return static_cast<LaneMask>(m_ready[c] & ~(m_carnivore[c] ^ kind) & (m_female[c] ^ female));
+                    };
+                };
+                LaneMask herbs = mobile & ~m_carnivore[i];
+                LaneMask carns = mobile & m_carnivore[i];
+                LaneMask decided = 0;
+
+                if (herbs) {
+                    // Fuite : la case libre voisine qui s'eloigne le plus du carnivore le plus proche.
+                    LaneMask threatened = nearest(x, y, 3, herbs, carnivores, hit);
+                    forEachLane(threatened, [&](int l) {
+                        int px = x + hit[l]->dx;
+                        int py = y + hit[l]->dy;
+                        int best = std::abs(hit[l]->dx) + std::abs(hit[l]->dy);
+                        int choice = kStay;
+                        for (int d = 0; d < 4; ++d) {
+                            int nx = x + kDirs[d][0];
+                            int ny = y + kDirs[d][1];
+                            if (!inBounds(nx, ny) || (m_animal[cellIndex(nx, ny)] & bit(l))) continue;
+                            int away = std::abs(nx - px) + std::abs(ny - py);
+                            if (away > best) {
+                                best = away;
+                                choice = d;
+                            }
+                        }
+                        if (choice == kStay) return;
+                        dir[l] = static_cast<std::uint8_t>(choice);
+                        decided |= bit(l);
+                    });
+
+                    LaneMask grazing = nearest(x, y, 4, herbs & ~decided, plants, hit);
+                    LaneMask mating = nearest(x, y, 5, herbs & ~decided & ~grazing & m_ready[i], mates(0), hit);
+                    forEachLane(grazing | mating, [&](int l) { dir[l] = static_cast<std::uint8_t>(hit[l]->step); });
+                    decided |= grazing | mating;
+                }
+
+                if (carns) {
+                    LaneMask hunting = nearest(x, y, 6, carns, herbivores, hit);
+                    LaneMask mating = nearest(x, y, 5, carns & ~hunting & m_ready[i], mates(static_cast<LaneMask>(~0u)), hit);
+                    forEachLane(hunting | mating, [&](int l) { dir[l] = static_cast<std::uint8_t>(hit[l]->step); });
+                    decided |= hunting | mating;
+                }
+
+                forEachLane(mobile & ~decided, [&](int l) {
+                    dir[l] = static_cast<std::uint8_t>(laneRandom(l, RandomStream::Move, i, 4));
+                });
+
+                forEachLane(mobile, [&](int l) {
+                    if (dir[l] == kStay) return;
+                    int nx = x + kDirs[dir[l]][0];
+                    int ny = y + kDirs[dir[l]][1];
+                    if (inBounds(nx, ny) && !(m_animal[cellIndex(nx, ny)] & bit(l))) m_moves[dir[l]][i] |= bit(l);
+                });
+            }
+        }
+    }
+
+    // Dans l'ordre des cellules d'origine, comme World::applyMoves : la premiere arrivee prend la case.
+    void Ensemble::applyMoves() {
+        for (int y = 0; y < m_height; ++y) {
+            for (int x = 0; x < m_width; ++x) {
+                int i = cellIndex(x, y);
+                for (int d = 0; d < 4; ++d) {
+                    LaneMask m = m_moves[d][i];
+                    if (!m) continue;
+                    int j = cellIndex(x + kDirs[d][0], y + kDirs[d][1]);
+                    m &= ~m_animal[j];
+                    if (m) moveAnimals(i, j, m);
+                }
+            }
+        }
+    }
+
+    // Nourrissage : HerbivoreFeeding et CarnivoreFeeding.
+
+    void Ensemble::sysFeed() {
+        for (int y = 0; y < m_height; ++y) {
+            for (int x = 0; x < m_width; ++x) {
+                int i = cellIndex(x, y);
+                if (!m_animal[i]) continue;
+
+                LaneMask eat = m_animal[i] & ~m_carnivore[i] & m_plant[i];
+                if (eat) {
+                    m_plant[i] &= ~eat;
+                    forEachLane(eat, [&](int l) {
+                        m_plants[l]--;
+                        feed(i, l);
+                    });
+                }
+
+                LaneMask hunt = m_animal[i] & m_carnivore[i];
+                for (int d = 0; d < 4 && hunt; ++d) {
+                    int nx = x + kDirs[d][0];
+                    int ny = y + kDirs[d][1];
+                    if (!inBounds(nx, ny)) continue;
+                    int j = cellIndex(nx, ny);
+                    LaneMask kill = hunt & m_animal[j] & ~m_carnivore[j];
+                    if (!kill) continue;
+                    removeAnimals(j, kill);
+                    forEachLane(kill, [&](int l) {
+                        m_kills[l]++;
+                        feed(i, l);
+                    });
+                    hunt &= ~kill;
+                }
+            }
+        }
+    }
+
+    // Reproduction : comme World::reproduceRows, les nouveau-nes comptent des leur naissance.
+
+    void Ensemble::sysReproduce() {
+        refreshReady();
+
+        for (int y = 0; y < m_height; ++y) {
+            for (int x = 0; x < m_width; ++x) {
+                int i = cellIndex(x, y);
+                LaneMask candidates = m_animal[i] & m_ready[i];
+
+                for (int d = 0; d < 4 && candidates; ++d) {
+                    int nx = x + kDirs[d][0];
+                    int ny = y + kDirs[d][1];
+                    if (!inBounds(nx, ny)) continue;
+                    int j = cellIndex(nx, ny);
+                    LaneMask pairs = candidates & m_ready[j]
+                        & ~(m_carnivore[i] ^ m_carnivore[j]) & (m_female[i] ^ m_female[j]);
+
+                    for (int e = 0; e < 4 && pairs; ++e) {
+                        int bx = x + kDirs[e][0];
+                        int by = y + kDirs[e][1];
+                        if (!inBounds(bx, by)) continue;
+                        int b = cellIndex(bx, by);
+                        LaneMask born = pairs & ~m_animal[b];
+                        if (!born) continue;
+
+                        m_animal[b] |= born;
+                        m_carnivore[b] |= born & m_carnivore[i];
+                        m_ready[b] |= born;
+                        forEachLane(born, [&](int l) {
+                            if (laneRandom(l, RandomStream::BirthGender, b, 2) != 0) m_female[b] |= bit(l);
+                            std::size_t k = static_cast<std::size_t>(b) * kLanes + l;
+                            m_satiety[k] = 0;
+                            m_hunger[k] = 0;
+                            m_cooldown[k] = 0;
+                            m_baby[k] = m_babyTurns[l];
+                            m_cooldown[static_cast<std::size_t>(i) * kLanes + l] = m_reproCooldown[l];
+                            m_cooldown[static_cast<std::size_t>(j) * kLanes + l] = m_reproCooldown[l];
+                            m_births[l]++;
+                        });
+                        m_ready[i] &= ~(born & m_cooldownLanes);
+                        m_ready[j] &= ~(born & m_cooldownLanes);
+
+                        pairs &= ~born;
+                        candidates &= ~born;
+                    }
+                }
+            }
+        }
+    }
+
+    // Propagation : toute plante du debut de la phase est une source, dans l'ordre des cellules.
+
+    void Ensemble::sysPlantsSpread() {
+        if (m_turn == 0) return;
+
+        const int totalCells = m_width * m_height;
+        LaneMask spreading = 0;
+        for (int l = 0; l < m_lanes; ++l) {
+            const Config& cfg = m_configs[l];
+            if (m_turn % cfg.plant_spread_period == 0 && m_plants[l] * 100 < cfg.max_plant_percent * totalCells) {
+                spreading |= bit(l);
+            }
+        }
+        if (!spreading) return;
+
+        std::copy(m_plant.begin(), m_plant.end(), m_sources.begin());
+        for (int y = 0; y < m_height && spreading; ++y) {
+            for (int x = 0; x < m_width; ++x) {
+                int i = cellIndex(x, y);
+                forEachLane(m_sources[i] & spreading, [&](int l) {
+                    auto [dx, dy] = kDirs[laneRandom(l, RandomStream::SpreadDirection, i, 4)];
+                    int nx = x + dx;
+                    int ny = y + dy;
+                    if (!inBounds(nx, ny)) return;
+                    int j = cellIndex(nx, ny);
+                    if ((m_plant[j] | m_animal[j]) & bit(l)) return;
+
+                    const Config& cfg = m_configs[l];
+                    if (laneRandom(l, RandomStream::SpreadChance, i, 100) >= cfg.plant_spread_chance_percent) return;
+                    m_plant[j] |= bit(l);
+                    if (++m_plants[l] * 100 >= cfg.max_plant_percent * totalCells) spreading &= ~bit(l);
+                });
+            }
+        }
+    }
+
+    void Ensemble::sysAging() {
+        static constexpr std::size_t kChunk = 4096;
+        const AgingKernel kernel = bestAgingKernel();
+        std::array<std::uint16_t, kChunk> starving;
+
+        for (std::size_t first = 0; first < m_animal.size(); first += kChunk) {
+            std::size_t cells = std::min(kChunk, m_animal.size() - first);
+            std::size_t k = first * kLanes;
+            AgingColumns columns{ &m_satiety[k], &m_hunger[k], &m_cooldown[k], &m_baby[k], m_starvationLimit.data() };
+            ageCells(kernel, columns, cells, starving.data());
+
+            for (std::size_t j = 0; j < cells; ++j) {
+                LaneMask dead = m_animal[first + j] & starving[j];
+                if (!dead) continue;
+                removeAnimals(static_cast<int>(first + j), dead);
+                forEachLane(dead, [&](int l) { m_deaths[l]++; });
+            }
+        }
+    }
+
+    void Ensemble::step() {
+        for (int l = 0; l < m_lanes; ++l) {
+            m_keys[l] = counterKey(m_configs[l].seed, static_cast<std::uint64_t>(m_turn));
+            m_births[l] = m_deaths[l] = m_kills[l] = 0;
+        }
+
+        decideMoves();
+        applyMoves();
+        sysFeed();
+        sysReproduce();
+        sysPlantsSpread();
+        sysAging();
+        m_turn++;
+    }
+
+    std::uint64_t Ensemble::stateHash(int lane) const {
+        std::uint64_t h = 0;
+        LaneMask b = bit(lane);
+        for (std::size_t i = 0; i < m_animal.size(); ++i) {
+            if (m_plant[i] & b) h ^= StateHash::plant(i);
+            if (!(m_animal[i] & b)) continue;
+            std::size_t k = i * kLanes + lane;
+            h ^= StateHash::animal(i,
+                (m_carnivore[i] & b) ? AnimalKind::Carnivore : AnimalKind::Herbivore,
+                (m_female[i] & b) ? Gender::Female : Gender::Male,
+                AnimalTimers::fromCounters(m_turn, m_satiety[k], m_hunger[k], m_cooldown[k], m_baby[k]));
+        }
+        return h;
+    }
+
+    TurnMetrics Ensemble::metrics(int lane) const {
+        TurnMetrics m;
+        m.turn = m_turn;
+        m.births = m_births[lane];
+        m.deaths = m_deaths[lane];
+        m.kills = m_kills[lane];
+        m.plants = m_plants[lane];
+
+        LaneMask b = bit(lane);
+        long long hunger = 0;
+        for (std::size_t i = 0; i < m_animal.size(); ++i) {
+            if (!(m_animal[i] & b)) continue;
+            std::size_t k = i * kLanes + lane;
+            bool isBaby = m_baby[k] > 0;
+            bool isMale = !(m_female[i] & b);
+            hunger += m_hunger[k];
+
+            if (m_carnivore[i] & b) {
+                int& slot = isBaby ? (isMale ? m.carnBabyMale : m.carnBabyFemale)
+                                   : (isMale ? m.carnMale : m.carnFemale);
+                slot++;
+            }
+            else {
+                int& slot = isBaby ? (isMale ? m.herbBabyMale : m.herbBabyFemale)
+                                   : (isMale ? m.herbMale : m.herbFemale);
+                slot++;
+            }
+        }
+
+        int animals = m.herbivores() + m.carnivores();
+        if (animals > 0) m.meanHunger = static_cast<float>(static_cast<double>(hunger) / animals);
+        return m;
+    }
+}
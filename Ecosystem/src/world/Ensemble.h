@@ -0,0 +1,116 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "core/Config.h"
+#include "core/CounterRandom.h"
+#include "core/MemoryStats.h"
+#include "MetricsRecorder.h"
+
+namespace Ecosystem {
+
+    // Jusqu'a kLanes petits mondes de memes dimensions avances ensemble, une voie
+    // par monde. Chaque voie a sa Config (graine, regles) et donne exactement les
+    // etats de World pour cette Config : memes regles, meme ordre de parcours,
+    // memes tirages (voir stateHash).
+    //
+    // Les voies sont entrelacees cellule par cellule : presence, espece et sexe
+    // sont des masques de kLanes bits par cellule, les compteurs des animaux des
+    // octets [cellule][voie]. Un parcours de la grille traite toutes les voies a
+    // la fois ; les voies qui n'ont rien a faire ne coutent rien.
+    class Ensemble {
+    public:
+        static constexpr int kLanes = 16;
+        using LaneMask = std::uint16_t;
+
+        // Une Config par voie (1 a kLanes), toutes de memes dimensions. L'etat
+        // initial de chaque voie est celui de World(config).
+        explicit Ensemble(const std::vector<Config>& lanes);
+
+        void step();
+
+        int lanes() const { return m_lanes; }
+        int turn() const { return m_turn; }
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        const Config& config(int lane) const { return m_configs[lane]; }
+
+        // Meme valeur que World::stateHash pour la Config de la voie.
+        std::uint64_t stateHash(int lane) const;
+        // Comme World::metrics pour la voie.
+        TurnMetrics metrics(int lane) const;
+
+    private:
+        template <class T>
+        using Column = std::vector<T, TrackingAllocator<T, MemCategory::Grid>>;
+        using Lanes = std::array<std::uint8_t, kLanes>;
+
+        // Deplacement de la recherche du plus proche, avec le pas qui s'en rapproche.
+        struct Offset {
+            int dx, dy;
+            int step;
+        };
+
+        std::vector<Config> m_configs;
+        int m_lanes = 0;
+        int m_width = 0;
+        int m_height = 0;
+        int m_turn = 0;
+
+        // Regles par voie.
+        Lanes m_satietyAfterEat{};
+        Lanes m_starvationLimit{};
+        Lanes m_reproCooldown{};
+        Lanes m_babyTurns{};
+        LaneMask m_cooldownLanes = 0; // voies dont repro_cool_down > 0
+        std::array<std::uint64_t, kLanes> m_keys{}; // cles de tirage du tour
+
+        // Masques par cellule.
+        Column<LaneMask> m_plant;
+        Column<LaneMask> m_animal;
+        Column<LaneMask> m_carnivore; // parmi m_animal
+        Column<LaneMask> m_female;    // parmi m_animal
+        Column<LaneMask> m_ready;     // repro_cooldown nul, tenu a jour par phase
+        std::array<Column<LaneMask>, 4> m_moves; // deplacements decides, par direction
+        Column<LaneMask> m_sources;
+
+        // Compteurs [cellule * kLanes + voie] ; sans signification hors de m_animal.
+        Column<std::uint8_t> m_satiety;
+        Column<std::uint8_t> m_hunger;
+        Column<std::uint8_t> m_cooldown;
+        Column<std::uint8_t> m_baby;
+
+        std::array<int, kLanes> m_plants{};
+        std::array<int, kLanes> m_births{};
+        std::array<int, kLanes> m_deaths{};
+        std::array<int, kLanes> m_kills{};
+
+        // Deplacements tries par (distance de Manhattan, ordre de parcours de Strategies.cpp) :
+        // le premier trouve est celui que retient la recherche ligne par ligne.
+        std::array<std::vector<Offset>, 7> m_nearest;
+
+        int cellIndex(int x, int y) const { return y * m_width + x; }
+        bool inBounds(int x, int y) const { return x >= 0 && x < m_width && y >= 0 && y < m_height; }
+        int laneRandom(int lane, RandomStream stream, int cell, int n) const {
+            return counterRandomIntKeyed(m_keys[lane], stream, static_cast<std::uint64_t>(cell), n);
+        }
+
+        void importLane(int lane);
+        void buildNearest();
+        template <class Target>
+        LaneMask nearest(int x, int y, int radius, LaneMask lanes, Target&& target,
+            std::array<const Offset*, kLanes>& hit) const;
+
+        void feed(int cell, int lane);
+        void removeAnimals(int cell, LaneMask m);
+        void moveAnimals(int from, int to, LaneMask m);
+        void refreshReady();
+
+        void decideMoves();
+        void applyMoves();
+        void sysFeed();
+        void sysReproduce();
+        void sysPlantsSpread();
+        void sysAging();
+    };
+}
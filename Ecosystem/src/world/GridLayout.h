@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+namespace Ecosystem {
+
+    // Disposition des cellules en memoire.
+    //  - RowMajor : y * largeur + x.
+    //  - Tiled    : tuiles de 2x2 cellules (une ligne de cache, sizeof(Cell) = 16)
+    //               rangees en ordre Z dans des blocs de 32x32, blocs en ordre ligne.
+    //               Les fenetres de recherche des strategies touchent alors
+    //               quelques lignes de cache contigues au lieu d'une par ligne.
+    //  - Padded   : ordre ligne entoure d'une bordure de PaddedGrid::kMargin cellules
+    //               toujours vides ; les voisinages se lisent par decalages lineaires
+    //               precalcules, sans test de bornes.
+    // Les systemes parcourent la grille dans l'ordre de la disposition : a graine
+    // egale, Tiled donne une autre trajectoire ; Padded garde celle de RowMajor.
+    enum class GridLayout {
+        RowMajor,
+        Tiled,
+        Padded
+    };
+
+    struct PaddedGrid {
+        // Plus grand rayon de recherche des strategies (proies des carnivores).
+        static constexpr int kMargin = 6;
+    };
+
+    struct TiledGrid {
+        static constexpr int kBlockBits = 5;
+        static constexpr int kBlock = 1 << kBlockBits;
+        static constexpr int kBlockCells = kBlock * kBlock;
+
+        // Bits de x (0..31) espaces d'un cran : le code Z vaut spread[x] | spread[y] << 1.
+        static constexpr std::array<std::uint16_t, kBlock> kSpread = [] {
+            std::array<std::uint16_t, kBlock> a{};
+            for (int v = 0; v < kBlock; ++v) {
+                std::uint16_t s = 0;
+                for (int b = 0; b < kBlockBits; ++b) {
+                    if (v & (1 << b)) s |= static_cast<std::uint16_t>(1u << (2 * b));
+                }
+                a[v] = s;
+            }
+            return a;
+        }();
+
+        // Position (x, y) dans le bloc de chaque rang de la courbe.
+        static constexpr std::array<std::array<std::uint8_t, 2>, kBlockCells> kPosition = [] {
+            std::array<std::array<std::uint8_t, 2>, kBlockCells> a{};
+            for (int y = 0; y < kBlock; ++y) {
+                for (int x = 0; x < kBlock; ++x) {
+                    a[kSpread[x] | (kSpread[y] << 1)] = { static_cast<std::uint8_t>(x), static_cast<std::uint8_t>(y) };
+                }
+            }
+            return a;
+        }();
+
+        static int blocksFor(int cells) { return (cells + kBlock - 1) >> kBlockBits; }
+
+        static int offset(int x, int y) {
+            return kSpread[x & (kBlock - 1)] | (kSpread[y & (kBlock - 1)] << 1);
+        }
+    };
+}
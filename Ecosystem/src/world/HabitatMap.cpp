@@ -0,0 +1,29 @@
+#include "HabitatMap.h"
+#include "stb_image.h"
+
+namespace Ecosystem {
+
+    void HabitatMap::FreePixels::operator()(std::uint8_t* p) const {
+        stbi_image_free(p);
+    }
+
+    HabitatMap::HabitatMap(const std::string& path) {
+        int channels = 0;
+        // Toujours 4 canaux : les niveaux de gris sont recopies dans R, G et B, alpha vaut 255.
+        m_pixels.reset(stbi_load(path.c_str(), &m_width, &m_height, &channels, 4));
+        if (!m_pixels) {
+            const char* reason = stbi_failure_reason();
+            m_error = reason ? reason : "lecture impossible";
+            m_width = m_height = 0;
+            return;
+        }
+
+        const std::size_t n = static_cast<std::size_t>(m_width) * m_height;
+        for (std::size_t i = 0; i < n; ++i) m_blocked += isBlocked(m_pixels.get() + i * 4) ? 1 : 0;
+    }
+
+    bool HabitatMap::readSize(const std::string& path, int& width, int& height) {
+        int channels = 0;
+        return stbi_info(path.c_str(), &width, &height, &channels) != 0;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Ecosystem {
+
+    // Carte d'habitat lue dans une image (PNG, PGM/PPM, BMP, TGA... via stb_image).
+    // Par pixel : vert = densite de plantes, rouge = herbivores, bleu = carnivores,
+    // de 0 a 255 (255 : plafond max_*_percent de Config). Un pixel noir pur ou
+    // transparent (alpha < 128) est infranchissable. En niveaux de gris, la valeur
+    // vaut pour les trois canaux.
+    class HabitatMap {
+    public:
+        // Carte vide si le fichier est illisible (voir error()).
+        explicit HabitatMap(const std::string& path);
+        // Dimensions lues dans l'en-tete, sans decoder l'image.
+        static bool readSize(const std::string& path, int& width, int& height);
+
+        bool empty() const { return !m_pixels; }
+        const std::string& error() const { return m_error; }
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        bool hasBlocked() const { return m_blocked > 0; }
+
+        struct Texel {
+            std::uint8_t plant;
+            std::uint8_t herbivore;
+            std::uint8_t carnivore;
+            bool blocked;
+        };
+        Texel at(int x, int y) const {
+            const std::uint8_t* p = m_pixels.get() + (static_cast<std::size_t>(y) * m_width + x) * 4;
+            return { p[1], p[0], p[2], isBlocked(p) };
+        }
+
+    private:
+        struct FreePixels {
+            void operator()(std::uint8_t* p) const;
+        };
+
+        int m_width = 0;
+        int m_height = 0;
+        std::unique_ptr<std::uint8_t, FreePixels> m_pixels; // RGBA
+        std::size_t m_blocked = 0;
+        std::string m_error;
+
+        static bool isBlocked(const std::uint8_t* p) {
+            return p[3] < 128 || (p[0] == 0 && p[1] == 0 && p[2] == 0);
+        }
+    };
+}
@@ -0,0 +1,280 @@
+#include "LevelOfDetail.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Ecosystem {
+
+    // Champ d'une espece
+
+    static double sum(const std::vector<double>& v) {
+        return std::accumulate(v.begin(), v.end(), 0.0);
+    }
+
+    double SpeciesField::total() const {
+        return sum(energy);
+    }
+
+    double SpeciesField::babies() const {
+        return baby.empty() ? 0.0 : sum(baby) - baby[0];
+    }
+
+    double SpeciesField::meanHunger(int satietyAfterEat) const {
+        double n = total();
+        if (n <= 0.0) return 0.0;
+        double h = 0.0;
+        for (std::size_t e = static_cast<std::size_t>(satietyAfterEat); e < energy.size(); ++e)
+            h += energy[e] * static_cast<double>(e - satietyAfterEat);
+        return h / n;
+    }
+
+    void SpeciesField::clear() {
+        std::fill(energy.begin(), energy.end(), 0.0);
+        std::fill(cooldown.begin(), cooldown.end(), 0.0);
+        std::fill(baby.begin(), baby.end(), 0.0);
+    }
+
+    void SpeciesField::scale(double factor) {
+        for (auto* v : { &energy, &cooldown, &baby })
+            for (double& x : *v) x *= factor;
+    }
+
+    static int clampIndex(int v, const std::vector<double>& to) {
+        return std::clamp(v, 0, static_cast<int>(to.size()) - 1);
+    }
+
+    void SpeciesField::add(const IAnimal& a, int satietyAfterEat, int turn) {
+        const AnimalTimers& t = a.timers();
+        int sat = t.satiety(turn);
+        int e = sat > 0 ? satietyAfterEat - std::min(sat, satietyAfterEat) : satietyAfterEat + t.hunger(turn);
+        energy[clampIndex(e, energy)] += 1.0;
+        cooldown[clampIndex(t.cooldown(turn), cooldown)] += 1.0;
+        baby[clampIndex(t.babyTurns(turn), baby)] += 1.0;
+    }
+
+    static int drawIndex(const std::vector<double>& v, std::mt19937_64& rng) {
+        double n = sum(v);
+        if (n <= 0.0) return 0;
+        double r = std::uniform_real_distribution<double>(0.0, n)(rng);
+        for (std::size_t k = 0; k < v.size(); ++k) {
+            r -= v[k];
+            if (r < 0.0) return static_cast<int>(k);
+        }
+        return static_cast<int>(v.size()) - 1;
+    }
+
+    SpeciesField::Drawn SpeciesField::draw(std::mt19937_64& rng, int satietyAfterEat) const {
+        int e = drawIndex(energy, rng);
+        Drawn d{};
+        d.satiety = e < satietyAfterEat ? satietyAfterEat - e : 0;
+        d.hunger = e < satietyAfterEat ? 0 : e - satietyAfterEat;
+        d.cooldown = drawIndex(cooldown, rng);
+        d.baby = drawIndex(baby, rng);
+        return d;
+    }
+
+    // Retire une unite du compartiment k ; s'il n'en contient pas assez, le reste
+    // est pris proportionnellement sur tous les compartiments.
+    static void removeOne(std::vector<double>& v, int k) {
+        double take = std::min(v[k], 1.0);
+        v[k] -= take;
+        double rest = 1.0 - take;
+        double n = sum(v);
+        if (rest <= 0.0 || n <= 0.0) return;
+        double f = std::max(0.0, (n - rest) / n);
+        for (double& x : v) x *= f;
+    }
+
+    void SpeciesField::remove(const Drawn& d, int satietyAfterEat) {
+        int e = d.satiety > 0 ? satietyAfterEat - d.satiety : satietyAfterEat + d.hunger;
+        removeOne(energy, clampIndex(e, energy));
+        removeOne(cooldown, clampIndex(d.cooldown, cooldown));
+        removeOne(baby, clampIndex(d.baby, baby));
+    }
+
+    // Modele en champ moyen
+
+    // Un animal qui cherche une cible a distance ~1 / (2 sqrt(densite)) l'atteint en
+    // autant de tours : probabilite par tour ~ 2 sqrt(densite).
+    static constexpr double kSearch = 1.0;
+    // Les herbivores fuient les carnivores a moins de 3 cases : une chasse sur deux aboutit.
+    static constexpr double kFlee = 0.5;
+
+    static double contact(double density) {
+        return 1.0 - std::pow(1.0 - std::clamp(density, 0.0, 1.0), 4.0);
+    }
+
+    void MeanFieldModel::shape(SpeciesField& s) const {
+        s.energy.assign(static_cast<std::size_t>(m_cfg.satiety_after_eat + std::max(1, m_cfg.starvation_limit)), 0.0);
+        s.cooldown.assign(static_cast<std::size_t>(m_cfg.repro_cool_down) + 1, 0.0);
+        s.baby.assign(static_cast<std::size_t>(m_cfg.baby_stay_turns) + 2, 0.0);
+    }
+
+    static void feedFraction(SpeciesField& s, double f) {
+        if (f <= 0.0) return;
+        f = std::min(f, 1.0);
+        for (std::size_t e = 1; e < s.energy.size(); ++e) {
+            double m = s.energy[e] * f;
+            s.energy[e] -= m;
+            s.energy[0] += m;
+        }
+    }
+
+    void MeanFieldModel::feed(AggregateTile& t, int area, LodEvents& ev) const {
+        SpeciesField& herbs = t.herbivores;
+        SpeciesField& carns = t.carnivores;
+
+        // Les bebes ne bougent pas ; une plante ne pousse jamais sous un animal.
+        double h = herbs.total();
+        if (h > 0.0) {
+            double adults = h - herbs.babies();
+            double eaters = std::min(t.plants, adults * std::min(1.0, kSearch * std::sqrt(t.plants / area)));
+            t.plants -= eaters;
+            feedFraction(herbs, eaters / h);
+        }
+
+        // Un carnivore mange une proie voisine ; les adultes la poursuivent avant.
+        h = herbs.total();
+        double c = carns.total();
+        if (h > 0.0 && c > 0.0) {
+            double rho = h / area;
+            double adjacent = contact(rho);
+            double hunt = std::max(adjacent, std::min(1.0, kSearch * std::sqrt(rho)) * kFlee);
+            double babies = carns.babies();
+            // Et une proie ne meurt que si un carnivore lui est voisin.
+            double kills = std::min(h * contact(c / area), babies * adjacent + (c - babies) * hunt);
+            herbs.scale(1.0 - kills / h);
+            feedFraction(carns, kills / c);
+            ev.kills += kills;
+        }
+    }
+
+    void MeanFieldModel::reproduce(SpeciesField& s, double animals, int area, LodEvents& ev) const {
+        double ready = s.cooldown[0];
+        if (ready <= 0.0) return;
+
+        // Partenaire de sexe oppose au repos a portee, puis une case voisine sans animal.
+        double meet = contact(ready / 2.0 / area);
+        double room = 1.0 - std::pow(std::clamp(animals / area, 0.0, 1.0), 4.0);
+        double pairs = std::min(ready / 2.0, ready * meet / 2.0 * room);
+        if (pairs <= 0.0) return;
+
+        std::size_t rest = s.cooldown.size() - 1;
+        s.cooldown[0] -= 2.0 * pairs;
+        s.cooldown[rest] += 2.0 * pairs;
+
+        s.energy[static_cast<std::size_t>(m_cfg.satiety_after_eat)] += pairs;
+        s.cooldown[0] += pairs;
+        s.baby.back() += pairs;
+        ev.births += pairs;
+    }
+
+    static void shiftDown(std::vector<double>& v) {
+        if (v.size() < 2) return;
+        v[0] += v[1];
+        for (std::size_t k = 1; k + 1 < v.size(); ++k) v[k] = v[k + 1];
+        v.back() = 0.0;
+    }
+
+    void MeanFieldModel::age(SpeciesField& s, LodEvents& ev) const {
+        double n = s.total();
+        if (n <= 0.0) return;
+
+        double dead = s.energy.back();
+        for (std::size_t e = s.energy.size() - 1; e > 0; --e) s.energy[e] = s.energy[e - 1];
+        s.energy[0] = 0.0;
+
+        if (dead > 0.0) {
+            double f = 1.0 - dead / n;
+            for (double& x : s.cooldown) x *= f;
+            for (double& x : s.baby) x *= f;
+            ev.deaths += dead;
+        }
+        shiftDown(s.cooldown);
+        shiftDown(s.baby);
+    }
+
+    void MeanFieldModel::step(AggregateTile& t, int area, bool spreadTurn, double& plantBudget, LodEvents& ev) const {
+        if (area <= 0) return;
+
+        feed(t, area, ev);
+
+        double animals = t.herbivores.total() + t.carnivores.total();
+        reproduce(t.herbivores, animals, area, ev);
+        animals = t.herbivores.total() + t.carnivores.total();
+        reproduce(t.carnivores, animals, area, ev);
+
+        if (spreadTurn && plantBudget > 0.0 && t.plants > 0.0) {
+            // Direction au hasard : la case visee doit etre sans plante ni animal.
+            double free = (1.0 - t.plants / area) * (1.0 - std::min(1.0, animals / area));
+            double grown = t.plants * m_cfg.plant_spread_chance_percent / 100.0 * std::max(0.0, free);
+            grown = std::min({ grown, plantBudget, area - t.plants });
+            t.plants += grown;
+            plantBudget -= grown;
+        }
+
+        age(t.herbivores, ev);
+        age(t.carnivores, ev);
+    }
+
+    // Tuiles
+
+    LevelOfDetail::LevelOfDetail(const Config& cfg, const LodOptions& opt)
+        : m_cfg(cfg), m_opt(opt), m_model(cfg) {
+        m_opt.tileSize = std::max(4, m_opt.tileSize);
+        m_tilesX = (cfg.width + m_opt.tileSize - 1) / m_opt.tileSize;
+        m_tilesY = (cfg.height + m_opt.tileSize - 1) / m_opt.tileSize;
+
+        m_mode.assign(tileCount(), TileMode::Detailed);
+        m_changed.assign(tileCount(), 0);
+        m_fields.resize(tileCount());
+        for (auto& f : m_fields) {
+            m_model.shape(f.herbivores);
+            m_model.shape(f.carnivores);
+        }
+    }
+
+    LevelOfDetail::LevelOfDetail(const LevelOfDetail& other, const Config& cfg)
+        : m_cfg(cfg), m_opt(other.m_opt), m_model(cfg),
+        m_tilesX(other.m_tilesX), m_tilesY(other.m_tilesY),
+        m_mode(other.m_mode), m_changed(other.m_changed), m_fields(other.m_fields), m_events(other.m_events) {
+    }
+
+    void LevelOfDetail::setRegionOfInterest(int x0, int y0, int x1, int y1) {
+        m_opt.roiX0 = x0;
+        m_opt.roiY0 = y0;
+        m_opt.roiX1 = x1;
+        m_opt.roiY1 = y1;
+    }
+
+    bool LevelOfDetail::inInterest(int t) const {
+        if (m_opt.roiX1 < m_opt.roiX0 || m_opt.roiY1 < m_opt.roiY0) return false;
+        int margin = m_opt.marginTiles * m_opt.tileSize;
+        int x0, y0, x1, y1;
+        bounds(t, x0, y0, x1, y1);
+        return x0 <= m_opt.roiX1 + margin && x1 > m_opt.roiX0 - margin
+            && y0 <= m_opt.roiY1 + margin && y1 > m_opt.roiY0 - margin;
+    }
+
+    void LevelOfDetail::setMode(int t, TileMode m, int turn) {
+        m_mode[t] = m;
+        m_changed[t] = turn;
+    }
+
+    int LevelOfDetail::aggregateTiles() const {
+        return static_cast<int>(std::count(m_mode.begin(), m_mode.end(), TileMode::Aggregate));
+    }
+
+    void LevelOfDetail::bounds(int t, int& x0, int& y0, int& x1, int& y1) const {
+        x0 = (t % m_tilesX) * m_opt.tileSize;
+        y0 = (t / m_tilesX) * m_opt.tileSize;
+        x1 = std::min(x0 + m_opt.tileSize, m_cfg.width);
+        y1 = std::min(y0 + m_opt.tileSize, m_cfg.height);
+    }
+
+    int LevelOfDetail::area(int t) const {
+        int x0, y0, x1, y1;
+        bounds(t, x0, y0, x1, y1);
+        return (x1 - x0) * (y1 - y0);
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "core/Config.h"
+#include "core/Interfaces.h"
+
+namespace Ecosystem {
+
+    // Simulation hybride : hors de la region d'interet, les tuiles calmes sont
+    // avancees par un modele en champ moyen au lieu d'individu par individu.
+    struct LodOptions {
+        int tileSize = 16;
+        // Region d'interet [x0,x1]x[y0,y1] en cellules, toujours simulee en detail,
+        // elargie de marginTiles tuiles.
+        int roiX0 = 0;
+        int roiY0 = 0;
+        int roiX1 = -1;
+        int roiY1 = -1;
+        int marginTiles = 1;
+        // Ecart de densite (par cellule) avec les tuiles voisines au-dela duquel une
+        // tuile est jugee heterogene ; il faut moitie moins pour redevenir agregee.
+        double heterogeneity = 0.2;
+        // Tours minimum entre deux changements de mode d'une meme tuile.
+        int minTurnsInMode = 8;
+    };
+
+    // Distribution d'une espece sur une tuile agregee. Les trois marginales sont
+    // supposees independantes, le sexe-ratio vaut 1:1.
+    struct SpeciesField {
+        // Indice e : satiete S - e si e < S, sinon faim e - S (S = satiety_after_eat).
+        std::vector<double> energy;
+        std::vector<double> cooldown; // tours de repos restants
+        std::vector<double> baby;     // tours de bebe restants
+
+        double total() const;
+        double babies() const;
+        double meanHunger(int satietyAfterEat) const;
+        void clear();
+        void scale(double factor);
+
+        // Compteurs de l'animal au tour turn.
+        void add(const IAnimal& a, int satietyAfterEat, int turn);
+        // Retire un individu tire dans les distributions et renvoie ses compteurs.
+        struct Drawn { int satiety, hunger, cooldown, baby; };
+        Drawn draw(std::mt19937_64& rng, int satietyAfterEat) const;
+        void remove(const Drawn& d, int satietyAfterEat);
+    };
+
+    struct AggregateTile {
+        double plants = 0.0;
+        SpeciesField herbivores;
+        SpeciesField carnivores;
+    };
+
+    // Evenements agreges d'un tour, en esperance.
+    struct LodEvents {
+        double births = 0.0;
+        double deaths = 0.0;
+        double kills = 0.0;
+    };
+
+    // Un tour du champ moyen, dans l'ordre de World::step, avec les regles et
+    // les taux de Config. Les rencontres (plante, proie, partenaire) sont
+    // estimees a partir des densites de la tuile.
+    class MeanFieldModel {
+    public:
+        explicit MeanFieldModel(const Config& cfg) : m_cfg(cfg) {}
+
+        void shape(SpeciesField& s) const;
+        // plantBudget : plantes que la propagation peut encore faire naitre dans tout le monde.
+        void step(AggregateTile& t, int area, bool spreadTurn, double& plantBudget, LodEvents& ev) const;
+
+    private:
+        const Config& m_cfg;
+
+        void feed(AggregateTile& t, int area, LodEvents& ev) const;
+        void reproduce(SpeciesField& s, double animals, int area, LodEvents& ev) const;
+        void age(SpeciesField& s, LodEvents& ev) const;
+    };
+
+    enum class TileMode : std::uint8_t { Detailed, Aggregate };
+
+    // Decoupage en tuiles et etat des tuiles agregees.
+    class LevelOfDetail {
+    public:
+        LevelOfDetail(const Config& cfg, const LodOptions& opt);
+        // Copie de l'etat des tuiles, avec les regles de cfg.
+        LevelOfDetail(const LevelOfDetail& other, const Config& cfg);
+
+        const LodOptions& options() const { return m_opt; }
+        const MeanFieldModel& model() const { return m_model; }
+        int tileSize() const { return m_opt.tileSize; }
+        int tilesX() const { return m_tilesX; }
+        int tilesY() const { return m_tilesY; }
+        int tileCount() const { return m_tilesX * m_tilesY; }
+
+        void setRegionOfInterest(int x0, int y0, int x1, int y1);
+        bool inInterest(int t) const;
+
+        TileMode mode(int t) const { return m_mode[t]; }
+        void setMode(int t, TileMode m, int turn);
+        int turnsInMode(int t, int turn) const { return turn - m_changed[t]; }
+        int aggregateTiles() const;
+
+        AggregateTile& field(int t) { return m_fields[t]; }
+        const AggregateTile& field(int t) const { return m_fields[t]; }
+
+        // Rectangle de cellules [x0,x1)x[y0,y1) de la tuile t.
+        void bounds(int t, int& x0, int& y0, int& x1, int& y1) const;
+        int area(int t) const;
+
+        LodEvents& events() { return m_events; }
+        const LodEvents& events() const { return m_events; }
+
+    private:
+        const Config& m_cfg;
+        LodOptions m_opt;
+        MeanFieldModel m_model;
+        int m_tilesX = 0;
+        int m_tilesY = 0;
+        std::vector<TileMode> m_mode;
+        std::vector<int> m_changed;
+        std::vector<AggregateTile> m_fields;
+        LodEvents m_events;
+    };
+}
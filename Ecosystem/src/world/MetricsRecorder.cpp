@@ -0,0 +1,109 @@
+#include "MetricsRecorder.h"
+#include <charconv>
+#include <cstring>
+
+namespace Ecosystem {
+
+    static const char* const kIntNames[] = {
+        "turn", "plants",
+        "herb_male", "herb_female", "herb_baby_male", "herb_baby_female",
+        "carn_male", "carn_female", "carn_baby_male", "carn_baby_female",
+        "births", "deaths", "kills"
+    };
+
+    static const char* const kMeanHungerName = "mean_hunger";
+
+    MetricsRecorder::MetricsRecorder(const std::string& basePath, std::size_t chunkRows)
+        : m_chunkRows(chunkRows == 0 ? 1 : chunkRows),
+        m_csv(basePath + ".csv", std::ios::binary),
+        m_bin(basePath + ".bin", std::ios::binary) {
+
+        for (auto& c : m_ints) c.resize(m_chunkRows);
+        m_meanHunger.resize(m_chunkRows);
+
+        if (isOpen()) writeHeaders();
+    }
+
+    MetricsRecorder::~MetricsRecorder() {
+        flush();
+    }
+
+    void MetricsRecorder::writeHeaders() {
+        std::uint32_t ncols = kIntColumns + 1;
+        m_bin.write("ECOMETR1", 8);
+        m_bin.write(reinterpret_cast<const char*>(&ncols), sizeof(ncols));
+
+        auto writeName = [&](const char* name, std::uint8_t type) {
+            std::uint8_t len = static_cast<std::uint8_t>(std::strlen(name));
+            m_bin.write(reinterpret_cast<const char*>(&type), 1);
+            m_bin.write(reinterpret_cast<const char*>(&len), 1);
+            m_bin.write(name, len);
+
+            m_csv.write(name, len);
+        };
+
+        for (std::size_t c = 0; c < kIntColumns; ++c) {
+            writeName(kIntNames[c], 0);
+            m_csv.put(',');
+        }
+        writeName(kMeanHungerName, 1);
+        m_csv.put('\n');
+    }
+
+    void MetricsRecorder::record(const TurnMetrics& m) {
+        const std::int32_t values[kIntColumns] = {
+            m.turn, m.plants,
+            m.herbMale, m.herbFemale, m.herbBabyMale, m.herbBabyFemale,
+            m.carnMale, m.carnFemale, m.carnBabyMale, m.carnBabyFemale,
+            m.births, m.deaths, m.kills
+        };
+        for (std::size_t c = 0; c < kIntColumns; ++c) {
+            m_ints[c][m_rows] = values[c];
+        }
+        m_meanHunger[m_rows] = m.meanHunger;
+
+        if (++m_rows == m_chunkRows) flush();
+    }
+
+    void MetricsRecorder::flush() {
+        if (m_rows == 0 || !isOpen()) return;
+
+        flushBinary();
+        flushCsv();
+
+        m_rowsWritten += m_rows;
+        m_rows = 0;
+        m_csv.flush();
+        m_bin.flush();
+    }
+
+    void MetricsRecorder::flushBinary() {
+        std::uint32_t rows = static_cast<std::uint32_t>(m_rows);
+        m_bin.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+        for (auto const& c : m_ints) {
+            m_bin.write(reinterpret_cast<const char*>(c.data()), m_rows * sizeof(std::int32_t));
+        }
+        m_bin.write(reinterpret_cast<const char*>(m_meanHunger.data()), m_rows * sizeof(float));
+    }
+
+    void MetricsRecorder::flushCsv() {
+        // Tampon fixe : une ligne tient largement en 256 octets.
+        char buf[8192];
+        char* p = buf;
+        char* const end = buf + sizeof(buf);
+
+        for (std::size_t r = 0; r < m_rows; ++r) {
+            if (end - p < 256) {
+                m_csv.write(buf, p - buf);
+                p = buf;
+            }
+            for (std::size_t c = 0; c < kIntColumns; ++c) {
+                p = std::to_chars(p, end, m_ints[c][r]).ptr;
+                *p++ = ',';
+            }
+            p = std::to_chars(p, end, m_meanHunger[r], std::chars_format::fixed, 3).ptr;
+            *p++ = '\n';
+        }
+        m_csv.write(buf, p - buf);
+    }
+}
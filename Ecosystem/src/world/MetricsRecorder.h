@@ -0,0 +1,76 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "core/MemoryStats.h"
+
+namespace Ecosystem {
+
+    struct TurnMetrics {
+        int turn = 0;
+        int plants = 0;
+
+        int herbMale = 0;
+        int herbFemale = 0;
+        int herbBabyMale = 0;
+        int herbBabyFemale = 0;
+
+        int carnMale = 0;
+        int carnFemale = 0;
+        int carnBabyMale = 0;
+        int carnBabyFemale = 0;
+
+        int births = 0;
+        int deaths = 0;
+        int kills = 0;
+
+        float meanHunger = 0.0f;
+
+        int herbivores() const { return herbMale + herbFemale + herbBabyMale + herbBabyFemale; }
+        int carnivores() const { return carnMale + carnFemale + carnBabyMale + carnBabyFemale; }
+    };
+
+    // Series temporelles par colonnes, videes par blocs vers un fichier binaire
+    // colonnaire (<base>.bin) et un CSV (<base>.csv).
+    //
+    // Format binaire : "ECOMETR1", u32 nbColonnes, puis par colonne u8 type
+    // (0 = i32, 1 = f32), u8 longueur, nom ; ensuite des blocs u32 nbLignes
+    // suivis des valeurs de chaque colonne a la suite.
+    class MetricsRecorder {
+    public:
+        explicit MetricsRecorder(const std::string& basePath, std::size_t chunkRows = 4096);
+        ~MetricsRecorder();
+
+        MetricsRecorder(const MetricsRecorder&) = delete;
+        MetricsRecorder& operator=(const MetricsRecorder&) = delete;
+
+        bool isOpen() const { return m_csv.is_open() && m_bin.is_open(); }
+
+        void record(const TurnMetrics& m);
+        void flush();
+
+        std::size_t rowsWritten() const { return m_rowsWritten; }
+
+    private:
+        static constexpr std::size_t kIntColumns = 13;
+
+        template <class T>
+        using Column = std::vector<T, TrackingAllocator<T, MemCategory::Output>>;
+
+        std::size_t m_chunkRows;
+        std::size_t m_rows = 0;
+        std::size_t m_rowsWritten = 0;
+
+        std::array<Column<std::int32_t>, kIntColumns> m_ints;
+        Column<float> m_meanHunger;
+
+        std::ofstream m_csv;
+        std::ofstream m_bin;
+
+        void writeHeaders();
+        void flushBinary();
+        void flushCsv();
+    };
+}
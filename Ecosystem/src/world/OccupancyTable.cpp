@@ -0,0 +1,78 @@
+#include "OccupancyTable.h"
+#include <algorithm>
+
+namespace Ecosystem {
+
+    const OccupancyTable::Table& OccupancyTable::layer(OccupancyLayer l) const {
+        switch (l) {
+        case OccupancyLayer::Plants: return m_plants;
+        case OccupancyLayer::Herbivores: return m_herbivores;
+        default: return m_carnivores;
+        }
+    }
+
+    int OccupancyTable::count(OccupancyLayer l, int x0, int y0, int x1, int y1) const {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, m_width - 1);
+        y1 = std::min(y1, m_height - 1);
+        if (x0 > x1 || y0 > y1) return 0;
+
+        const auto& t = layer(l);
+        return t[at(x1 + 1, y1 + 1)] - t[at(x0, y1 + 1)]
+             - t[at(x1 + 1, y0)] + t[at(x0, y0)];
+    }
+
+    void OccupancyTable::advise(int y0, int y1, Residency r) const {
+        y0 = std::clamp(y0, 0, m_height + 1);
+        y1 = std::clamp(y1, y0, m_height + 1);
+        std::size_t begin = static_cast<std::size_t>(at(0, y0));
+        std::size_t bytes = static_cast<std::size_t>(at(0, y1) - at(0, y0)) * sizeof(std::int32_t);
+        for (const Table* t : { &m_plants, &m_herbivores, &m_carnivores }) {
+            if (t->size() >= begin + bytes / sizeof(std::int32_t)) adviseMapped(t->data() + begin, bytes, r);
+        }
+    }
+
+    void OccupancyTable::resize(int width, int height) {
+        m_width = width;
+        m_height = height;
+        const std::size_t n = static_cast<std::size_t>(width + 1) * (height + 1);
+        for (Table* t : { &m_plants, &m_herbivores, &m_carnivores }) t->resize(n);
+    }
+
+    // Chaque case est reecrite : seules la premiere ligne et la premiere colonne
+    // sont remises a zero, sans repasser sur toute la table.
+    void OccupancyTable::beginRebuild(int width, int height) {
+        m_width = width;
+        m_height = height;
+        const std::size_t n = static_cast<std::size_t>(width + 1) * (height + 1);
+        for (Table* t : { &m_plants, &m_herbivores, &m_carnivores }) {
+            if (t->size() != n) t->assign(n, 0);
+            std::fill(t->begin(), t->begin() + (width + 1), 0);
+        }
+    }
+
+    void OccupancyTable::touch(int y0, int y1) {
+        y0 = std::clamp(y0, 0, m_height + 1);
+        y1 = std::clamp(y1, y0, m_height + 1);
+        std::size_t begin = static_cast<std::size_t>(at(0, y0));
+        std::size_t bytes = static_cast<std::size_t>(at(0, y1) - at(0, y0)) * sizeof(std::int32_t);
+        for (Table* t : { &m_plants, &m_herbivores, &m_carnivores }) {
+            if (t->size() >= begin + bytes / sizeof(std::int32_t)) touchPages(t->data() + begin, bytes);
+        }
+    }
+
+    std::int64_t OccupancyTable::residentBytes() const {
+        std::int64_t total = 0;
+        for (const Table* t : { &m_plants, &m_herbivores, &m_carnivores }) {
+            std::int64_t r = Ecosystem::residentBytes(t->data(), t->size() * sizeof(std::int32_t));
+            if (r < 0) return -1;
+            total += r;
+        }
+        return total;
+    }
+
+    int OccupancyTable::countInRadius(OccupancyLayer l, int x, int y, int radius) const {
+        return count(l, x - radius, y - radius, x + radius, y + radius);
+    }
+}
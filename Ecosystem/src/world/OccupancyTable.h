@@ -0,0 +1,91 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include "core/Interfaces.h"
+#include "core/MemoryStats.h"
+#include "core/MappedStorage.h"
+
+namespace Ecosystem {
+
+    enum class OccupancyLayer {
+        Plants,
+        Herbivores,
+        Carnivores
+    };
+
+    // Tables de sommes cumulees (integral images) par espece.
+    // Toute requete rectangulaire se resout en quatre lectures.
+    class OccupancyTable {
+    public:
+        OccupancyTable() = default;
+        explicit OccupancyTable(const CellAllocator<std::int32_t, MemCategory::Grid>& alloc)
+            : m_plants(alloc), m_herbivores(alloc), m_carnivores(alloc) {}
+
+        template <class CellAt>
+        void rebuild(int width, int height, CellAt&& cellAt);
+        // Meme reconstruction en plusieurs fois : beginRebuild, puis rebuildRows sur
+        // des bandes consecutives de 0 a height.
+        void beginRebuild(int width, int height);
+        template <class CellAt>
+        void rebuildRows(int y0, int y1, CellAt&& cellAt);
+        // Dimensionne les tables sans les remplir : rebuild ecrit toutes les cases.
+        void resize(int width, int height);
+
+        int count(OccupancyLayer layer, int x0, int y0, int x1, int y1) const;
+        int countInRadius(OccupancyLayer layer, int x, int y, int radius) const;
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+
+        // Conseil de residence pour les lignes [y0, y1) des trois tables.
+        void advise(int y0, int y1, Residency r) const;
+        // Premier acces aux lignes [y0, y1) des trois tables (voir CowPages::touch).
+        void touch(int y0, int y1);
+        std::int64_t residentBytes() const;
+
+    private:
+        int m_width = 0;
+        int m_height = 0;
+
+        using Table = std::vector<std::int32_t, CellAllocator<std::int32_t, MemCategory::Grid>>;
+
+        Table m_plants;
+        Table m_herbivores;
+        Table m_carnivores;
+
+        const Table& layer(OccupancyLayer l) const;
+        int at(int x, int y) const { return y * (m_width + 1) + x; }
+    };
+
+    template <class CellAt>
+    void OccupancyTable::rebuild(int width, int height, CellAt&& cellAt) {
+        beginRebuild(width, height);
+        rebuildRows(0, height, cellAt);
+    }
+
+    template <class CellAt>
+    void OccupancyTable::rebuildRows(int y0, int y1, CellAt&& cellAt) {
+        const int width = m_width;
+        for (int y = y0; y < y1; ++y) {
+            int rowPlants = 0, rowHerbs = 0, rowCarns = 0;
+            m_plants[at(0, y + 1)] = 0;
+            m_herbivores[at(0, y + 1)] = 0;
+            m_carnivores[at(0, y + 1)] = 0;
+            for (int x = 0; x < width; ++x) {
+                const auto& c = cellAt(x, y);
+                if (c.plant) rowPlants++;
+                if (c.animal) {
+                    if (c.animal->kind() == AnimalKind::Herbivore) rowHerbs++;
+                    else rowCarns++;
+                }
+
+                int i = at(x + 1, y + 1);
+                int up = at(x + 1, y);
+                m_plants[i] = m_plants[up] + rowPlants;
+                m_herbivores[i] = m_herbivores[up] + rowHerbs;
+                m_carnivores[i] = m_carnivores[up] + rowCarns;
+            }
+        }
+    }
+}
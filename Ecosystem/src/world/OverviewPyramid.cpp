@@ -0,0 +1,52 @@
+#include "OverviewPyramid.h"
+
+namespace Ecosystem {
+
+    void OverviewPyramid::reset(int width, int height) {
+        // Les niveaux existants sont reutilises : remettre a zero n'alloue pas.
+        std::size_t count = 0;
+        for (int level = 0;; ++level) {
+            int side = tileSide(level);
+            if (m_levels.size() <= count) m_levels.emplace_back();
+            Level& l = m_levels[count++];
+            l.tilesX = (width + side - 1) / side;
+            l.tilesY = (height + side - 1) / side;
+            l.tiles.assign(static_cast<std::size_t>(l.tilesX) * l.tilesY, TileCounts{});
+            if (side >= width && side >= height) break;
+        }
+        while (m_levels.size() > count) m_levels.pop_back();
+    }
+
+    TileCounts OverviewPyramid::animalCounts(IAnimal& a, int sign) {
+        TileCounts d;
+        if (a.kind() == AnimalKind::Herbivore) d.herbivores = sign;
+        else d.carnivores = sign;
+        if (a.timers().baby()) d.babies = sign;
+        return d;
+    }
+
+    void OverviewPyramid::add(int x, int y, const TileCounts& delta) {
+        x >>= kBaseBits;
+        y >>= kBaseBits;
+        for (auto& l : m_levels) {
+            l.tiles[static_cast<std::size_t>(y) * l.tilesX + x] += delta;
+            x >>= 1;
+            y >>= 1;
+        }
+    }
+
+    // Les deux cellules partagent toutes les tuiles a partir d'un certain niveau.
+    void OverviewPyramid::moveAnimal(int x0, int y0, int x1, int y1, IAnimal& a) {
+        TileCounts plus = animalCounts(a, 1);
+        TileCounts minus = animalCounts(a, -1);
+        x0 >>= kBaseBits; y0 >>= kBaseBits;
+        x1 >>= kBaseBits; y1 >>= kBaseBits;
+        for (auto& l : m_levels) {
+            if (x0 == x1 && y0 == y1) return;
+            l.tiles[static_cast<std::size_t>(y0) * l.tilesX + x0] += minus;
+            l.tiles[static_cast<std::size_t>(y1) * l.tilesX + x1] += plus;
+            x0 >>= 1; y0 >>= 1;
+            x1 >>= 1; y1 >>= 1;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "core/Interfaces.h"
+#include "core/MemoryStats.h"
+#include "CowPages.h"
+
+namespace Ecosystem {
+
+    struct TileCounts {
+        std::int32_t plants = 0;
+        std::int32_t herbivores = 0;
+        std::int32_t carnivores = 0;
+        std::int32_t babies = 0;
+
+        TileCounts& operator+=(const TileCounts& o) {
+            plants += o.plants;
+            herbivores += o.herbivores;
+            carnivores += o.carnivores;
+            babies += o.babies;
+            return *this;
+        }
+    };
+
+    // Pyramide de comptages par tuile, facon mipmap : le niveau 0 compte des tuiles
+    // de 4x4 cellules, chaque niveau suivant regroupe 2x2 tuiles du precedent, jusqu'a
+    // une seule tuile. Tenue a jour par les mutations de World (O(niveaux) chacune),
+    // elle permet un apercu dont le cout suit la vue et non le monde.
+    class OverviewPyramid {
+    public:
+        static constexpr int kBaseBits = 2;
+
+        void reset(int width, int height);
+
+        int levels() const { return static_cast<int>(m_levels.size()); }
+        // Cote des tuiles du niveau, en cellules.
+        static int tileSide(int level) { return 1 << (kBaseBits + level); }
+        int tilesX(int level) const { return m_levels[level].tilesX; }
+        int tilesY(int level) const { return m_levels[level].tilesY; }
+        const TileCounts& at(int level, int tx, int ty) const {
+            auto const& l = m_levels[level];
+            return l.tiles[static_cast<std::size_t>(ty) * l.tilesX + tx];
+        }
+
+        // Coordonnees locales (ligne relative au debut du stockage).
+        void addPlant(int x, int y, int sign) { add(x, y, { sign, 0, 0, 0 }); }
+        void addAnimal(int x, int y, IAnimal& a, int sign) { add(x, y, animalCounts(a, sign)); }
+        void addBaby(int x, int y, int sign) { add(x, y, { 0, 0, 0, sign }); }
+        void moveAnimal(int x0, int y0, int x1, int y1, IAnimal& a);
+
+    private:
+        struct Level {
+            int tilesX = 0;
+            int tilesY = 0;
+            CowPages<TileCounts, MemCategory::Grid> tiles;
+        };
+        std::vector<Level> m_levels;
+
+        static TileCounts animalCounts(IAnimal& a, int sign);
+        void add(int x, int y, const TileCounts& delta);
+    };
+}
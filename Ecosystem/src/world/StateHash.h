@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include "core/Interfaces.h"
+#include "core/CounterRandom.h"
+
+namespace Ecosystem {
+
+    // Cles de type Zobrist derivees d'un melangeur (splitmix64) plutot que de tables :
+    // aucune memoire par cellule, et la meme cle quel que soit le stockage de la grille.
+    namespace StateHash {
+
+        enum Feature : std::uint64_t {
+            PlantPresent = 1,
+            HerbivoreMale,
+            HerbivoreFemale,
+            CarnivoreMale,
+            CarnivoreFemale,
+            HungryAt,
+            CooldownEnd,
+            AdultAt
+        };
+
+        inline std::uint64_t mix(std::uint64_t z) {
+            return splitmix64(z);
+        }
+
+        inline std::uint64_t key(std::uint64_t cell, Feature f, std::uint64_t value = 0) {
+            return mix((cell << 4 | f) ^ mix(value * 0x100000001B3ull + f));
+        }
+
+        inline std::uint64_t plant(std::uint64_t cell) {
+            return key(cell, PlantPresent);
+        }
+
+        // Les echeances plutot que les compteurs qui s'en deduisent : l'etat d'un
+        // animal ne change qu'a ses transitions, pas a chaque tour.
+        inline std::uint64_t animal(std::uint64_t cell, AnimalKind kind, Gender gender, const AnimalTimers& t) {
+            Feature id = (kind == AnimalKind::Herbivore)
+                ? (gender == Gender::Male ? HerbivoreMale : HerbivoreFemale)
+                : (gender == Gender::Male ? CarnivoreMale : CarnivoreFemale);
+
+            return key(cell, id)
+                ^ key(cell, HungryAt, static_cast<std::uint32_t>(t.hungryAt))
+                ^ key(cell, CooldownEnd, static_cast<std::uint32_t>(t.cooldownEnd))
+                ^ key(cell, AdultAt, static_cast<std::uint32_t>(t.adultAt));
+        }
+
+        inline std::uint64_t animal(std::uint64_t cell, const IAnimal& a) {
+            return animal(cell, a.kind(), a.gender(), a.timers());
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include "TimerWheel.h"
+#include <bit>
+#include <utility>
+
+namespace Ecosystem {
+
+    void TimerWheel::reset(int now) {
+        m_now = now;
+        m_size = 0;
+        m_nodes.clear();
+        m_free = -1;
+        for (auto& level : m_levels) level.fill(List{});
+        m_overflow = List{};
+        m_firing = List{};
+        m_cascadeLevel = -1;
+        m_moving = List{};
+    }
+
+    void TimerWheel::beginAdvance() {
+        ++m_now;
+        m_cascadeLevel = kLevels;
+    }
+
+    void TimerWheel::schedule(const TimerEntry& e) {
+        std::int32_t n = m_free;
+        if (n >= 0) {
+            m_free = m_nodes[n].next;
+            m_nodes[n].entry = e;
+        }
+        else {
+            n = static_cast<std::int32_t>(m_nodes.size());
+            m_nodes.push_back({ e, -1 });
+        }
+        insert(n);
+        m_size++;
+    }
+
+    // Niveau : le chiffre (en base kSlots) le plus haut ou l'echeance et le tour courant different.
+    void TimerWheel::insert(std::int32_t n) {
+        auto due = static_cast<std::uint32_t>(m_nodes[n].entry.due);
+        auto diff = due ^ static_cast<std::uint32_t>(m_now);
+        int level = diff == 0 ? 0 : (std::bit_width(diff) - 1) / kBits;
+        List& l = level >= kLevels ? m_overflow : m_levels[level][(due >> (level * kBits)) & (kSlots - 1)];
+
+        m_nodes[n].next = -1;
+        if (l.tail >= 0) m_nodes[l.tail].next = n;
+        else l.head = n;
+        l.tail = n;
+    }
+
+    // Du plus haut niveau au plus bas : une entree peut descendre de plusieurs niveaux.
+    bool TimerWheel::cascade(std::size_t& budget) {
+        const auto t = static_cast<std::uint32_t>(m_now);
+        auto entered = [&](int level) { return (t & ((std::uint32_t(1) << (level * kBits)) - 1)) == 0; };
+
+        while (m_cascadeLevel >= 0) {
+            while (m_moving.head >= 0) {
+                if (budget == 0) return false;
+                std::int32_t n = m_moving.head;
+                m_moving.head = m_nodes[n].next;
+                insert(n);
+                budget--;
+            }
+            int level = m_cascadeLevel--;
+            if (level == kLevels) {
+                if (entered(kLevels)) m_moving = std::exchange(m_overflow, List{});
+            }
+            else if (level > 0) {
+                if (entered(level)) m_moving = std::exchange(m_levels[level][(t >> (level * kBits)) & (kSlots - 1)], List{});
+            }
+            else {
+                m_firing = std::exchange(dueList(), List{});
+                m_cascadeLevel = -1;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "core/MemoryStats.h"
+
+namespace Ecosystem {
+
+    enum class TimerKind : std::uint8_t {
+        Adult,    // fin des tours de bebe
+        Rested,   // fin du repos apres reproduction
+        Starving  // faim au seuil de starvation_limit
+    };
+
+    // Reveil d'un animal, designe par son emplacement dans la table des reveils du
+    // monde ; une generation differente veut dire que l'animal n'est plus la.
+    struct TimerEntry {
+        std::int32_t slot;
+        std::uint32_t generation;
+        std::int32_t due;
+        TimerKind kind;
+    };
+
+    // Roue hierarchique indexee par tour : kLevels niveaux de kSlots cases, une case
+    // du niveau L couvrant kSlots^L tours. Une entree est rangee au plus bas niveau
+    // dont le bloc contient a la fois son echeance et le tour courant ; les cases d'un
+    // niveau sont redescendues quand le tour courant y entre. Programmer coute O(1),
+    // avancer d'un tour ne touche que les entrees qui echoient ou descendent.
+    //
+    // Les cases sont des listes chainees dans un seul reservoir de noeuds : descendre
+    // ne copie rien, et le tas n'est sollicite que si le nombre d'entrees depasse son
+    // maximum precedent.
+    class TimerWheel {
+    public:
+        static constexpr int kBits = 6;
+        static constexpr int kSlots = 1 << kBits;
+        static constexpr int kLevels = 4;
+
+        // Vide la roue ; le tour courant devient now.
+        void reset(int now);
+        int now() const { return m_now; }
+        std::size_t size() const { return m_size; }
+
+        // Echeance apres le tour courant.
+        void schedule(const TimerEntry& e);
+        // Passe au tour now() + 1 et appelle fire(entree) pour chacune de celles qui y
+        // echoient, dans l'ordre ou elles ont ete rangees. fire peut programmer.
+        template <class Fire>
+        void advance(Fire&& fire);
+        // advance en plusieurs fois : beginAdvance passe au tour suivant, fireDue redescend
+        // puis appelle fire pour au plus limit entrees en tout et renvoie true quand il
+        // n'en reste plus.
+        void beginAdvance();
+        template <class Fire>
+        bool fireDue(Fire&& fire, std::size_t limit);
+
+    private:
+        struct Node {
+            TimerEntry entry;
+            std::int32_t next;
+        };
+        struct List {
+            std::int32_t head = -1;
+            std::int32_t tail = -1;
+        };
+
+        int m_now = 0;
+        std::size_t m_size = 0;
+        std::vector<Node, TrackingAllocator<Node, MemCategory::Animals>> m_nodes;
+        std::int32_t m_free = -1;
+        std::array<std::array<List, kSlots>, kLevels> m_levels;
+        List m_overflow; // au-dela du dernier niveau
+        List m_firing;   // entrees echues au tour courant, pas encore traitees
+        // Descente en cours : prochain niveau a vider (kLevels pour m_overflow, -1 une
+        // fois les echeances du tour reprises dans m_firing) et entrees restant a ranger.
+        int m_cascadeLevel = -1;
+        List m_moving;
+
+        void insert(std::int32_t node);
+        // Redescend les cases dans lesquelles le tour courant vient d'entrer, au plus
+        // budget entrees ; true quand m_firing est pret.
+        bool cascade(std::size_t& budget);
+        List& dueList() { return m_levels[0][static_cast<std::uint32_t>(m_now) & (kSlots - 1)]; }
+    };
+
+    template <class Fire>
+    void TimerWheel::advance(Fire&& fire) {
+        beginAdvance();
+        fireDue(fire, std::numeric_limits<std::size_t>::max());
+    }
+
+    template <class Fire>
+    bool TimerWheel::fireDue(Fire&& fire, std::size_t limit) {
+        if (!cascade(limit)) return false;
+        for (std::size_t k = 0; k < limit && m_firing.head >= 0; ++k) {
+            std::int32_t n = m_firing.head;
+            TimerEntry e = m_nodes[n].entry;
+            m_firing.head = m_nodes[n].next;
+            m_nodes[n].next = m_free;
+            m_free = n;
+            m_size--;
+            fire(e);
+        }
+        if (m_firing.head >= 0) return false;
+        m_firing = List{};
+        return true;
+    }
+}
@@ -2,16 +2,75 @@
 #include "./factory/EntityFactory.h"
 #include "./core/Strategies.h"
 #include "core/ConsoleColor.h"
+#include "core/Parallel.h"
+#include "core/PerfCounters.h"
+#include "core/Topology.h"
+#include "HabitatMap.h"
+#include "StateHash.h"
 #include <iostream>
+#include <algorithm>
 #include <array>
 #include <cstdlib>
 #include <random>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <charconv>
+#include <cstring>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <utility>
 
 namespace Ecosystem {
 
-    World::World(Config& cfg) : cfg_(cfg) {
-        std::srand(cfg_.seed);
-        grid_.resize(cfg_.width * cfg_.height);
+    World::World(Config& cfg, GridLayout layout) : World(cfg, 0, cfg.height, layout) {}
+
+    static std::shared_ptr<const std::string> storageDirectory(const Config& cfg) {
+        if (cfg.mapped_storage_dir.empty()) return nullptr;
+        return std::make_shared<const std::string>(cfg.mapped_storage_dir);
+    }
+
+    // Pages anonymes non touchees des que leur placement compte.
+    static PageKind storagePages(const Config& cfg) {
+        if (cfg.huge_pages) return PageKind::Huge;
+        return cfg.numa_placement ? PageKind::Anonymous : PageKind::Heap;
+    }
+
+    World::World(Config& cfg, int rowBegin, int rowEnd, GridLayout layout)
+        : cfg_(cfg),
+        rowBegin_(std::clamp(rowBegin, 0, cfg.height)),
+        rowEnd_(std::clamp(rowEnd, rowBegin_, cfg.height)),
+        layout_(layout),
+        grid_(CellAllocator<Cell, MemCategory::Grid>(storageDirectory(cfg), storagePages(cfg))),
+        occupancy_(std::make_shared<OccupancyTable>(
+            CellAllocator<std::int32_t, MemCategory::Grid>(storageDirectory(cfg), storagePages(cfg)))) {
+        if (layout_ == GridLayout::Tiled) {
+            blocksPerRow_ = TiledGrid::blocksFor(cfg_.width);
+            grid_.resize(static_cast<std::size_t>(blocksPerRow_) * TiledGrid::blocksFor(rowEnd_ - rowBegin_)
+                * TiledGrid::kBlockCells);
+        }
+        else if (layout_ == GridLayout::Padded) {
+            padStride_ = cfg_.width + 2 * PaddedGrid::kMargin;
+            grid_.resize(static_cast<std::size_t>(padStride_) * (rowEnd_ - rowBegin_ + 2 * PaddedGrid::kMargin));
+            buildOffsets();
+        }
+        else {
+            grid_.resize(static_cast<std::size_t>(cfg_.width) * (rowEnd_ - rowBegin_));
+        }
+        if (cfg_.numa_placement) placeOnNodes();
+
+        if (grid_.get_allocator().mapped()) {
+            // Bandes d'environ 4 Mo (cellules et tables d'occupation), alignees sur les blocs tuiles.
+            constexpr std::size_t kBandBytes = std::size_t(4) << 20;
+            std::size_t rowBytes = static_cast<std::size_t>(cfg_.width) * (sizeof(Cell) + 3 * sizeof(std::int32_t));
+            streamRows_ = static_cast<int>(std::max<std::size_t>(16, kBandBytes / std::max<std::size_t>(rowBytes, 1)));
+            if (layout_ == GridLayout::Tiled) {
+                streamRows_ = (streamRows_ + TiledGrid::kBlock - 1) / TiledGrid::kBlock * TiledGrid::kBlock;
+            }
+        }
 
         std::mt19937 rng(cfg_.seed);
         auto randInRange = [&](int base) {
@@ -22,13 +81,242 @@ namespace Ecosystem {
             return dist(rng);
             };
 
-        int nPlants = randInRange(cfg_.initial_plants);
-        int nHerbs = randInRange(cfg_.initial_herbivores);
-        int nCarns = randInRange(cfg_.initial_carnivores);
+        if (!cfg_.habitat_map.empty()) {
+            HabitatMap map(cfg_.habitat_map);
+            if (map.empty()) throw std::runtime_error("carte d'habitat illisible : " + cfg_.habitat_map + " (" + map.error() + ")");
+            seedHabitat(map);
+        }
+        else {
+            int nPlants = randInRange(cfg_.initial_plants);
+            int nHerbs = randInRange(cfg_.initial_herbivores);
+            int nCarns = randInRange(cfg_.initial_carnivores);
+
+            seedPlants(nPlants, rng);
+            seedAnimals(nHerbs, nCarns, rng);
+        }
+        rebuildOccupancy();
+        rebuildFrontier();
+        rebuildTimers();
+        rebuildOverview(overview_);
+        hash_ = recomputeStateHash();
+
+        allocationsAtStart_ = MemoryStats::I().totalAllocations();
+    }
+
+    World::World(const World& parent, Config& cfg)
+        : cfg_(cfg),
+        rowBegin_(parent.rowBegin_),
+        rowEnd_(parent.rowEnd_),
+        layout_(parent.layout_),
+        blocksPerRow_(parent.blocksPerRow_),
+        grid_(parent.grid_),
+        padStride_(parent.padStride_),
+        windowOffsets_(parent.windowOffsets_),
+        windowStart_(parent.windowStart_),
+        neighborOffsets_(parent.neighborOffsets_),
+        turn_(parent.turn_),
+        hash_(parent.hash_),
+        births_(parent.births_),
+        deaths_(parent.deaths_),
+        kills_(parent.kills_),
+        occupancy_(parent.occupancy_),
+        frontier_(parent.frontier_),
+        plantCount_(parent.plantCount_),
+        blocked_(parent.blocked_),
+        timers_(parent.timers_),
+        animalSlots_(parent.animalSlots_),
+        freeAnimalSlots_(parent.freeAnimalSlots_),
+        mobile_(parent.mobile_),
+        ready_(parent.ready_),
+        lodDensity_(parent.lodDensity_),
+        overview_(parent.overview_),
+        streamRows_(parent.streamRows_) {
+        if (parent.lod_) lod_ = std::make_unique<LevelOfDetail>(*parent.lod_, cfg_);
+        allocationsAtStart_ = MemoryStats::I().totalAllocations();
+    }
+
+    std::unique_ptr<World> World::fork() const {
+        return fork(cfg_);
+    }
+
+    std::unique_ptr<World> World::fork(Config& cfg) const {
+        // Deplacements, sources et reveils du tour en cours ne sont pas copies.
+        if (inTurn()) throw std::logic_error("embranchement : un tour decoupe est en cours");
+        if (cfg.width != cfg_.width || cfg.height != cfg_.height) {
+            throw std::invalid_argument("embranchement : la configuration doit garder les dimensions du monde");
+        }
+        return std::unique_ptr<World>(new World(*this, cfg));
+    }
+
+    // Disposition
+
+    void World::positionOf(int i, int& x, int& y) const {
+        if (layout_ == GridLayout::RowMajor) {
+            x = i % cfg_.width;
+            y = i / cfg_.width + rowBegin_;
+            return;
+        }
+        if (layout_ == GridLayout::Padded) {
+            x = i % padStride_ - PaddedGrid::kMargin;
+            y = i / padStride_ - PaddedGrid::kMargin + rowBegin_;
+            return;
+        }
+        int block = i / TiledGrid::kBlockCells;
+        auto p = TiledGrid::kPosition[i % TiledGrid::kBlockCells];
+        x = (block % blocksPerRow_) * TiledGrid::kBlock + p[0];
+        y = (block / blocksPerRow_) * TiledGrid::kBlock + p[1] + rowBegin_;
+    }
+
+    std::pair<int, int> World::storageSpan(int y0, int y1) const {
+        y0 = std::max(y0, rowBegin_) - rowBegin_;
+        y1 = std::min(y1, rowEnd_) - rowBegin_;
+        if (y1 <= y0) return { 0, 0 };
+        if (layout_ == GridLayout::RowMajor) return { y0 * cfg_.width, y1 * cfg_.width };
+        if (layout_ == GridLayout::Padded) {
+            return { (y0 + PaddedGrid::kMargin) * padStride_, (y1 + PaddedGrid::kMargin) * padStride_ };
+        }
+
+        int blockRow = blocksPerRow_ * TiledGrid::kBlockCells;
+        return { (y0 >> TiledGrid::kBlockBits) * blockRow,
+                 (((y1 - 1) >> TiledGrid::kBlockBits) + 1) * blockRow };
+    }
+
+    template <class Fn>
+    void World::forEachCell(int y0, int y1, Fn&& fn) const {
+        y0 = std::max(y0, rowBegin_);
+        y1 = std::min(y1, rowEnd_);
+        if (y1 <= y0) return;
+
+        if (layout_ != GridLayout::Tiled) {
+            for (int y = y0; y < y1; ++y) {
+                if (streamRows_) streamRow(y);
+                int i = idx(0, y);
+                for (int x = 0; x < cfg_.width; ++x, ++i)
+                    fn(x, y, i);
+            }
+            return;
+        }
+
+        constexpr int B = TiledGrid::kBlock;
+        int ly0 = y0 - rowBegin_;
+        int ly1 = y1 - rowBegin_;
+        for (int by = ly0 / B; by * B < ly1; ++by) {
+            if (streamRows_) streamRow(std::max(by * B, ly0) + rowBegin_);
+            bool wholeRows = by * B >= ly0 && (by + 1) * B <= ly1;
+            for (int bx = 0; bx < blocksPerRow_; ++bx) {
+                int base = (by * blocksPerRow_ + bx) * TiledGrid::kBlockCells;
+                bool whole = wholeRows && (bx + 1) * B <= cfg_.width;
+                for (int k = 0; k < TiledGrid::kBlockCells; ++k) {
+                    auto p = TiledGrid::kPosition[k];
+                    int x = bx * B + p[0];
+                    int ly = by * B + p[1];
+                    if (!whole && (x >= cfg_.width || ly < ly0 || ly >= ly1)) continue;
+                    fn(x, ly + rowBegin_, base + k);
+                }
+            }
+        }
+    }
+
+    template <class Fn>
+    void World::forEachSet(const CowPages<std::uint64_t, MemCategory::Grid>& bits, int y0, int y1, Fn&& fn) const {
+        auto [first, last] = storageSpan(y0, y1);
+        for (int i = first; i < last;) {
+            std::uint64_t word = bits[i >> 6] >> (i & 63);
+            if (!word) {
+                i = ((i >> 6) + 1) << 6;
+                continue;
+            }
+            i += std::countr_zero(word);
+            if (i >= last) break;
+            int x, y;
+            positionOf(i, x, y);
+            if (y >= y0 && y < y1) {
+                if (streamRows_) streamRow(y);
+                fn(x, y, i);
+            }
+            ++i;
+        }
+    }
+
+    template <class Fn>
+    int World::forEachSetFrom(const CowPages<std::uint64_t, MemCategory::Grid>& bits, int from, int limit, Fn&& fn) const {
+        const int last = storageEnd();
+        int n = 0;
+        for (int i = from; i < last;) {
+            std::uint64_t word = bits[i >> 6] >> (i & 63);
+            if (!word) {
+                i = ((i >> 6) + 1) << 6;
+                continue;
+            }
+            i += std::countr_zero(word);
+            if (i >= last) break;
+            if (n == limit) return i;
+            int x, y;
+            positionOf(i, x, y);
+            if (streamRows_) streamRow(y);
+            fn(x, y, i);
+            ++n;
+            ++i;
+        }
+        return last;
+    }
+
+    template <class Fn>
+    void World::forEachStored(int first, int last, Fn&& fn) const {
+        for (int i = first; i < last; ++i) {
+            int x, y;
+            positionOf(i, x, y);
+            if (x < 0 || x >= cfg_.width || y < rowBegin_ || y >= rowEnd_) continue;
+            if (streamRows_) streamRow(y);
+            fn(x, y, i);
+        }
+    }
 
-        seedPlants(nPlants);
-        seedHerbivores(nHerbs);
-        seedCarnivores(nCarns);
+    int World::countSet(const CowPages<std::uint64_t, MemCategory::Grid>& bits, int y0, int y1) const {
+        auto [first, last] = storageSpan(y0, y1);
+        int n = 0;
+        for (int w = first >> 6; w < (last + 63) >> 6; ++w) n += std::popcount(bits[w]);
+        return n;
+    }
+
+    void World::streamRow(int y) const {
+        int band = (y - rowBegin_) / streamRows_;
+        if (band == streamBand_) return;
+
+        int prev = streamBand_;
+        streamBand_ = band;
+        if (prev >= 0) {
+            for (int b = prev - 1; b <= prev + 1; ++b) {
+                if (std::abs(b - band) > 1) adviseBand(b, Residency::Release);
+            }
+        }
+        if (prev < 0 || std::abs(band - prev) > 1) {
+            adviseBand(band - 1, Residency::WillNeed);
+            adviseBand(band, Residency::WillNeed);
+        }
+        adviseBand(band + 1, Residency::WillNeed);
+    }
+
+    void World::adviseBand(int band, Residency r) const {
+        int y0 = rowBegin_ + band * streamRows_;
+        if (band < 0 || y0 >= rowEnd_) return;
+        int y1 = std::min(y0 + streamRows_, rowEnd_);
+
+        auto [first, last] = storageSpan(y0, y1);
+        grid_.advise(first, last, r);
+        occupancy_->advise(y0 - rowBegin_, y1 - rowBegin_ + 1, r);
+    }
+
+    void World::buildOffsets() {
+        windowOffsets_.clear();
+        for (int r = 0; r <= PaddedGrid::kMargin; ++r) {
+            windowStart_[r] = static_cast<int>(windowOffsets_.size());
+            for (int dy = -r; dy <= r; ++dy)
+                for (int dx = -r; dx <= r; ++dx)
+                    windowOffsets_.push_back({ dy * padStride_ + dx, static_cast<std::int8_t>(dx), static_cast<std::int8_t>(dy) });
+        }
+        windowStart_[PaddedGrid::kMargin + 1] = static_cast<int>(windowOffsets_.size());
+        neighborOffsets_ = { 1, -1, padStride_, -padStride_ };
     }
 
     Cell* World::getCell(int x, int y) {
@@ -40,186 +328,929 @@ namespace Ecosystem {
         return &grid_[idx(x, y)];
     }
 
-    void World::seedPlants(int n) {
+    void World::rebuildOccupancy() {
+        beginOccupancy();
+        occupancyRows(rowBegin_, rowEnd_);
+    }
+
+    void World::beginOccupancy() {
+        if (occupancy_.use_count() > 1) {
+            occupancy_ = std::make_shared<OccupancyTable>(
+                CellAllocator<std::int32_t, MemCategory::Grid>(grid_.get_allocator().directory(), grid_.get_allocator().pages()));
+        }
+        occupancy_->beginRebuild(cfg_.width, rowEnd_ - rowBegin_);
+    }
+
+    void World::occupancyRows(int y0, int y1) {
+        occupancy_->rebuildRows(y0 - rowBegin_, y1 - rowBegin_,
+            [this](int x, int y) -> const Cell& {
+                if (x == 0 && streamRows_) streamRow(y + rowBegin_);
+                return std::as_const(grid_)[idx(x, y + rowBegin_)];
+            });
+    }
 
-        int totalCells = cfg_.width * cfg_.height;
-        int maxPlants = (totalCells * cfg_.max_plant_percent) / 100;
-        n = std::min(n, maxPlants);
+    World::RegionCounts World::regionCounts(int x0, int y0, int x1, int y1) const {
+        y0 -= rowBegin_;
+        y1 -= rowBegin_;
+        RegionCounts r;
+        r.plants = occupancy_->count(OccupancyLayer::Plants, x0, y0, x1, y1);
+        r.herbivores = occupancy_->count(OccupancyLayer::Herbivores, x0, y0, x1, y1);
+        r.carnivores = occupancy_->count(OccupancyLayer::Carnivores, x0, y0, x1, y1);
+        return r;
+    }
 
-        int planted = 0;
-        int guard = n * 20 + 1000;
+    int World::countInRadius(OccupancyLayer layer, int x, int y, int radius) const {
+        return occupancy_->countInRadius(layer, x, y - rowBegin_, radius);
+    }
 
-        while (planted < n && guard--) {
-            int x = std::rand() % cfg_.width;
-            int y = std::rand() % cfg_.height;
-            auto& c = grid_[idx(x, y)];
-            if (!c.plant) {
-                c.plant = EntityFactory::makePlant();
-                planted++;
-            }
+    // Mutations
+
+    static void setBit(CowPages<std::uint64_t, MemCategory::Grid>& bits, int i, bool on) {
+        std::uint64_t bit = std::uint64_t(1) << (i & 63);
+        if (on) bits[i >> 6] |= bit;
+        else bits[i >> 6] &= ~bit;
+    }
+
+    static void moveBit(CowPages<std::uint64_t, MemCategory::Grid>& bits, int from, int to) {
+        bool on = (std::as_const(bits)[from >> 6] >> (from & 63)) & 1;
+        setBit(bits, from, false);
+        setBit(bits, to, on);
+    }
+
+    void World::eatPlant(int x, int y) {
+        int i = idx(x, y);
+        auto& c = grid_[i];
+        if (!c.plant) return;
+        hash_ ^= StateHash::plant(cellKey(i));
+        overview_.addPlant(x, y - rowBegin_, -1);
+        c.plant.reset();
+        plantCount_--;
+        touchFrontier(i);
+    }
+
+    void World::killAnimal(int x, int y) {
+        int i = idx(x, y);
+        auto& c = grid_[i];
+        if (!c.animal) return;
+        hash_ ^= StateHash::animal(cellKey(i), *c.animal);
+        overview_.addAnimal(x, y - rowBegin_, *c.animal, -1);
+        releaseAnimal(i);
+        c.animal.reset();
+        kills_++;
+        touchFrontier(i);
+    }
+
+    void World::feedAnimal(int x, int y) {
+        int i = idx(x, y);
+        auto& c = grid_[i];
+        if (!c.animal) return;
+        hash_ ^= StateHash::animal(cellKey(i), *c.animal);
+        c.animal->timers().hungryAt = turn_ + cfg_.satiety_after_eat;
+        hash_ ^= StateHash::animal(cellKey(i), *c.animal);
+    }
+
+    void World::moveAnimal(int from, int to) {
+        auto& src = grid_[from];
+        hash_ ^= StateHash::animal(cellKey(from), *src.animal);
+        grid_[to].animal = std::move(src.animal);
+        hash_ ^= StateHash::animal(cellKey(to), *grid_[to].animal);
+        animalSlots_[grid_[to].animal->timers().slot].cell = to;
+        moveBit(mobile_, from, to);
+        moveBit(ready_, from, to);
+        auto [x0, y0] = localPosition(from);
+        auto [x1, y1] = localPosition(to);
+        overview_.moveAnimal(x0, y0, x1, y1, *grid_[to].animal);
+        touchFrontier(from);
+        touchFrontier(to);
+    }
+
+    void World::spawnAnimal(int i, std::unique_ptr<IAnimal> a) {
+        placeAnimal(i, std::move(a));
+        births_++;
+    }
+
+    void World::placeAnimal(int i, std::unique_ptr<IAnimal> a) {
+        hash_ ^= StateHash::animal(cellKey(i), *a);
+        auto [x, y] = localPosition(i);
+        overview_.addAnimal(x, y, *a, 1);
+        grid_[i].animal = std::move(a);
+        adoptAnimal(i);
+        touchFrontier(i);
+    }
+
+    void World::clearCell(int i) {
+        auto& c = grid_[i];
+        auto [x, y] = localPosition(i);
+        if (c.plant) {
+            hash_ ^= StateHash::plant(cellKey(i));
+            overview_.addPlant(x, y, -1);
+            c.plant.reset();
+            plantCount_--;
+        }
+        if (c.animal) {
+            hash_ ^= StateHash::animal(cellKey(i), *c.animal);
+            overview_.addAnimal(x, y, *c.animal, -1);
+            releaseAnimal(i);
+            c.animal.reset();
+        }
+        touchFrontier(i);
+    }
+
+    void World::spawnPlant(int i) {
+        hash_ ^= StateHash::plant(cellKey(i));
+        auto [x, y] = localPosition(i);
+        overview_.addPlant(x, y, 1);
+        grid_[i].plant = EntityFactory::makePlant(turn_);
+        plantCount_++;
+        touchFrontier(i);
+    }
+
+    void World::setReproCooldown(int i, int value) {
+        IAnimal& a = *grid_[i].animal;
+        AnimalTimers& t = a.timers();
+        hash_ ^= StateHash::animal(cellKey(i), a);
+        t.cooldownEnd = value > 0 ? turn_ + value : 0;
+        hash_ ^= StateHash::animal(cellKey(i), a);
+        setBit(ready_, i, value <= 0);
+        if (value > 0) schedule(t.slot, TimerKind::Rested, t.cooldownEnd);
+    }
+
+    // Reveils
+
+    void World::rebuildTimers() {
+        timers_.reset(turn_);
+        animalSlots_.clear();
+        freeAnimalSlots_.clear();
+        heldSlots_.clear();
+        mobile_.assign(frontier_.size(), 0);
+        ready_.assign(frontier_.size(), 0);
+        forEachCell(rowBegin_, rowEnd_, [&](int, int, int i) {
+            if (grid_[i].animal) adoptAnimal(i);
+        });
+    }
+
+    void World::adoptAnimal(int i) {
+        AnimalTimers& t = grid_[i].animal->timers();
+        std::int32_t slot;
+        if (!freeAnimalSlots_.empty()) {
+            slot = freeAnimalSlots_.back();
+            freeAnimalSlots_.pop_back();
         }
+        else {
+            slot = static_cast<std::int32_t>(animalSlots_.size());
+            animalSlots_.push_back({ 0, 0, {}, {} });
+        }
+        animalSlots_[slot].cell = i;
+        animalSlots_[slot].mother = {};
+        animalSlots_[slot].father = {};
+        t.slot = slot;
+
+        setBit(mobile_, i, t.adultAt == 0);
+        setBit(ready_, i, t.cooldownEnd == 0);
+        if (t.adultAt != 0) schedule(slot, TimerKind::Adult, t.adultAt);
+        if (t.cooldownEnd != 0) schedule(slot, TimerKind::Rested, t.cooldownEnd);
+        schedule(slot, TimerKind::Starving, starvationTurn(t));
+    }
+
+    void World::releaseAnimal(int i) {
+        std::int32_t slot = grid_[i].animal->timers().slot;
+        animalSlots_[slot].generation++;
+        (holdSlots_ ? heldSlots_ : freeAnimalSlots_).push_back(slot);
+        setBit(mobile_, i, false);
+        setBit(ready_, i, false);
+    }
+
+    void World::holdReleasedSlots(bool hold) {
+        holdSlots_ = hold;
+        if (hold) return;
+        freeAnimalSlots_.insert(freeAnimalSlots_.end(), heldSlots_.begin(), heldSlots_.end());
+        heldSlots_.clear();
+    }
+
+    // Identites
+
+    World::AnimalHandle World::handleAt(int x, int y) const {
+        if (!inBounds(x, y) || !grid_[idx(x, y)].animal) return {};
+        std::int32_t slot = grid_[idx(x, y)].animal->timers().slot;
+        return { slot, animalSlots_[slot].generation };
+    }
+
+    const IAnimal* World::find(AnimalHandle h, int* x, int* y) const {
+        if (!h.valid() || h.slot >= static_cast<std::int32_t>(animalSlots_.size())) return nullptr;
+        const AnimalSlot& s = animalSlots_[h.slot];
+        if (s.generation != h.generation) return nullptr;
+        int cx, cy;
+        positionOf(s.cell, cx, cy);
+        if (x) *x = cx;
+        if (y) *y = cy;
+        return grid_[s.cell].animal.get();
+    }
+
+    World::AnimalRecord World::record(AnimalHandle h) const {
+        AnimalRecord r;
+        r.handle = h;
+        const IAnimal* a = find(h, &r.x, &r.y);
+        if (!a) return r;
+        const AnimalTimers& t = a->timers();
+        r.alive = true;
+        r.hunger = t.hunger(turn_);
+        r.satiety = t.satiety(turn_);
+        r.baby = t.babyTurns(turn_) > 0;
+        r.mother = animalSlots_[h.slot].mother;
+        r.father = animalSlots_[h.slot].father;
+        return r;
+    }
+
+    void World::records(const std::vector<AnimalHandle>& handles, std::vector<AnimalRecord>& out) const {
+        out.clear();
+        out.reserve(handles.size());
+        for (AnimalHandle h : handles) out.push_back(record(h));
     }
 
+    void World::schedule(std::int32_t slot, TimerKind kind, int due) {
+        timers_.schedule({ slot, animalSlots_[slot].generation, due, kind });
+    }
 
-    void World::seedHerbivores(int n) {
-        int maxAllowed = cfg_.width * cfg_.height * cfg_.max_herbivore_percent;
-        if (n > maxAllowed) n = maxAllowed;
+    // Frontiere des plantes
 
-        int placed = 0, guard = n * 20 + 1000;
-        while (placed < n && guard--) {
-            int x = std::rand() % cfg_.width;
-            int y = std::rand() % cfg_.height;
-            auto& c = grid_[idx(x, y)];
-            if (!c.animal) {
-                c.animal = EntityFactory::makeHerbivore();
-                placed++;
+    void World::rebuildFrontier() {
+        frontier_.assign((grid_.size() + 63) / 64, 0);
+        plantCount_ = 0;
+        for (int y = rowBegin_; y < rowEnd_; ++y) {
+            for (int x = 0; x < cfg_.width; ++x) {
+                if (std::as_const(grid_)[idx(x, y)].plant) plantCount_++;
+                updateFrontierBit(x, y);
             }
         }
     }
 
-    void World::seedCarnivores(int n) {
+    void World::updateFrontierBit(int x, int y) {
+        int i = idx(x, y);
+        bool open = std::as_const(grid_)[i].plant
+            && (isEmptyCell(x + 1, y) || isEmptyCell(x - 1, y) || isEmptyCell(x, y + 1) || isEmptyCell(x, y - 1));
+        std::uint64_t bit = std::uint64_t(1) << (i & 63);
+        if (open) frontier_[i >> 6] |= bit;
+        else frontier_[i >> 6] &= ~bit;
+    }
+
+    void World::touchFrontier(int i) {
+        int x, y;
+        positionOf(i, x, y);
+        updateFrontierBit(x, y);
+        if (inBounds(x + 1, y)) updateFrontierBit(x + 1, y);
+        if (inBounds(x - 1, y)) updateFrontierBit(x - 1, y);
+        if (inBounds(x, y + 1)) updateFrontierBit(x, y + 1);
+        if (inBounds(x, y - 1)) updateFrontierBit(x, y - 1);
+    }
+
+    // Niveau de detail
 
-        int maxAllowed = cfg_.width * cfg_.height * cfg_.max_carnivore_percent;
-        if (n > maxAllowed) n = maxAllowed;
+    void World::enableLevelOfDetail(const LodOptions& opt) {
+        if (rowBegin_ != 0 || rowEnd_ != cfg_.height) return;
 
-        int placed = 0, guard = n * 20 + 1000;
-        while (placed < n && guard--) {
-            int x = std::rand() % cfg_.width;
-            int y = std::rand() % cfg_.height;
-            auto& c = grid_[idx(x, y)];
-            if (!c.animal) { c.animal = EntityFactory::makeCarnivore(); placed++; }
+        lod_ = std::make_unique<LevelOfDetail>(cfg_, opt);
+        lodDensity_.resize(lod_->tileCount());
+        // Toutes les tuiles peuvent changer de mode des le prochain tour.
+        for (int t = 0; t < lod_->tileCount(); ++t) {
+            lod_->setMode(t, TileMode::Detailed, turn_ - lod_->options().minTurnsInMode);
         }
     }
 
-    // D�placements
+    void World::setRegionOfInterest(int x0, int y0, int x1, int y1) {
+        if (lod_) lod_->setRegionOfInterest(x0, y0, x1, y1);
+    }
 
-    void World::sysMove() {
-        struct Move { int x, y, nx, ny; };
-        std::vector<Move> moves;
-        moves.reserve(cfg_.width * cfg_.height / 2);
+    int World::aggregatePlants() const {
+        if (!lod_) return 0;
+        double plants = 0.0;
+        for (int t = 0; t < lod_->tileCount(); ++t) {
+            if (lod_->mode(t) == TileMode::Aggregate) plants += lod_->field(t).plants;
+        }
+        return static_cast<int>(std::lround(plants));
+    }
 
-        for (int y = 0; y < cfg_.height; y++) {
-            for (int x = 0; x < cfg_.width; x++) {
+    static int roundStochastic(double v, std::mt19937_64& rng) {
+        if (v <= 0.0) return 0;
+        double whole = std::floor(v);
+        return static_cast<int>(whole) + (std::uniform_real_distribution<double>(0.0, 1.0)(rng) < v - whole ? 1 : 0);
+    }
 
-                auto& cell = grid_[idx(x, y)];
-                if (!cell.animal) continue;
+    std::array<double, 3> World::tileDensity(int t) const {
+        double area = lod_->area(t);
+        if (lod_->mode(t) == TileMode::Aggregate) {
+            auto const& f = lod_->field(t);
+            return { f.plants / area, f.herbivores.total() / area, f.carnivores.total() / area };
+        }
+        int x0, y0, x1, y1;
+        lod_->bounds(t, x0, y0, x1, y1);
+        RegionCounts r = regionCounts(x0, y0, x1 - 1, y1 - 1);
+        return { r.plants / area, r.herbivores / area, r.carnivores / area };
+    }
 
-                auto& a = *cell.animal;
+    bool World::tileHeterogeneous(int t, double threshold) const {
+        int tx = t % lod_->tilesX();
+        int ty = t / lod_->tilesX();
+        std::array<double, 3> mean{};
+        int neighbors = 0;
+        for (auto [dx, dy] : { std::pair{1, 0}, std::pair{-1, 0}, std::pair{0, 1}, std::pair{0, -1} }) {
+            int nx = tx + dx, ny = ty + dy;
+            if (nx < 0 || ny < 0 || nx >= lod_->tilesX() || ny >= lod_->tilesY()) continue;
+            for (int k = 0; k < 3; ++k) mean[k] += lodDensity_[ny * lod_->tilesX() + nx][k];
+            neighbors++;
+        }
+        if (neighbors == 0) return false;
+        for (int k = 0; k < 3; ++k) {
+            if (std::abs(lodDensity_[t][k] - mean[k] / neighbors) > threshold) return true;
+        }
+        return false;
+    }
 
-                if (a.baby_turns_ref() > 0) {
-                    a.baby_turns_ref()--;
-                    continue;
+    // Ce qui est entre dans une tuile agregee (deplacement, naissance, propagation)
+    // rejoint ses distributions.
+    void World::absorbTile(int t) {
+        AggregateTile& f = lod_->field(t);
+        int x0, y0, x1, y1;
+        lod_->bounds(t, x0, y0, x1, y1);
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                int i = idx(x, y);
+                auto const& c = std::as_const(grid_)[i];
+                if (!c.plant && !c.animal) continue;
+                if (c.plant) f.plants += 1.0;
+                if (c.animal) {
+                    auto& s = c.animal->kind() == AnimalKind::Herbivore ? f.herbivores : f.carnivores;
+                    s.add(*c.animal, cfg_.satiety_after_eat, turn_);
                 }
+                clearCell(i);
+            }
+        }
+    }
+
+    void World::aggregateTile(int t) {
+        absorbTile(t);
+        lod_->setMode(t, TileMode::Aggregate, turn_);
+    }
+
+    static std::unique_ptr<IAnimal> makeDrawn(AnimalKind kind, Gender g, const SpeciesField::Drawn& d, int turn) {
+        std::unique_ptr<IAnimal> a = kind == AnimalKind::Herbivore
+            ? EntityFactory::makeHerbivore(g) : EntityFactory::makeCarnivore(g);
+        a->timers() = AnimalTimers::fromCounters(turn, d.satiety, d.hunger, d.cooldown, d.baby);
+        return a;
+    }
 
-                auto next = a.movement().choose_next(*this, x, y);
+    // Retour en detail : les effectifs arrondis sont places sur des cellules tirees
+    // au hasard, avec des compteurs tires dans les distributions de la tuile.
+    void World::materializeTile(int t) {
+        AggregateTile& f = lod_->field(t);
+        std::mt19937_64 rng(counterRandom(cfg_.seed, static_cast<std::uint64_t>(turn_), RandomStream::LevelOfDetail,
+            static_cast<std::uint64_t>(t)));
+
+        int x0, y0, x1, y1;
+        lod_->bounds(t, x0, y0, x1, y1);
+        lodCells_.clear();
+        lodCells_.reserve(static_cast<std::size_t>(x1 - x0) * (y1 - y0));
+        for (int y = y0; y < y1; ++y)
+            for (int x = x0; x < x1; ++x)
+                if (!isBlocked(idx(x, y))) lodCells_.push_back(idx(x, y));
+
+        int area = static_cast<int>(lodCells_.size());
+        auto pick = [&](int k) {
+            for (int j = 0; j < k; ++j) {
+                int r = j + std::uniform_int_distribution<int>(0, area - 1 - j)(rng);
+                std::swap(lodCells_[j], lodCells_[r]);
+            }
+        };
+
+        int plants = std::min(area, roundStochastic(f.plants, rng));
+        pick(plants);
+        for (int j = 0; j < plants; ++j) spawnPlant(lodCells_[j]);
+
+        int herbs = std::min(area, roundStochastic(f.herbivores.total(), rng));
+        int carns = std::min(area - herbs, roundStochastic(f.carnivores.total(), rng));
+        pick(herbs + carns);
+        for (int j = 0; j < herbs + carns; ++j) {
+            bool herb = j < herbs;
+            SpeciesField& s = herb ? f.herbivores : f.carnivores;
+            auto d = s.draw(rng, cfg_.satiety_after_eat);
+            s.remove(d, cfg_.satiety_after_eat);
+            Gender g = (rng() & 1) ? Gender::Female : Gender::Male;
+            placeAnimal(lodCells_[j], makeDrawn(herb ? AnimalKind::Herbivore : AnimalKind::Carnivore, g, d, turn_));
+        }
 
-                if (!inBounds(next.x, next.y)) continue;
+        f.plants = 0.0;
+        f.herbivores.clear();
+        f.carnivores.clear();
+        lod_->setMode(t, TileMode::Detailed, turn_);
+    }
 
-                auto& dst = grid_[idx(next.x, next.y)];
+    // Echanges avec les tuiles detaillees voisines, symetriques de l'absorption : un
+    // adulte au bord traverse avec une chance sur quatre, une plante au bord propage
+    // vers l'exterieur une fois sur quatre.
+    void World::emitMigrants(int t, double& plantBudget) {
+        AggregateTile& f = lod_->field(t);
+        std::mt19937_64 rng(counterRandom(cfg_.seed, static_cast<std::uint64_t>(turn_), RandomStream::LevelOfDetail,
+            static_cast<std::uint64_t>(lod_->tileCount() + t)));
+
+        int x0, y0, x1, y1;
+        lod_->bounds(t, x0, y0, x1, y1);
+        double area = lod_->area(t);
+        int tx = t % lod_->tilesX();
+        int ty = t / lod_->tilesX();
+
+        for (auto [dx, dy] : { std::pair{1, 0}, std::pair{-1, 0}, std::pair{0, 1}, std::pair{0, -1} }) {
+            int nx = tx + dx, ny = ty + dy;
+            if (nx < 0 || ny < 0 || nx >= lod_->tilesX() || ny >= lod_->tilesY()) continue;
+            if (lod_->mode(ny * lod_->tilesX() + nx) != TileMode::Detailed) continue;
+
+            // Ligne de cellules de la voisine qui touche la tuile.
+            int length = dx != 0 ? y1 - y0 : x1 - x0;
+            auto edgeCell = [&](int k) {
+                if (dx > 0) return idx(x1, y0 + k);
+                if (dx < 0) return idx(x0 - 1, y0 + k);
+                if (dy > 0) return idx(x0 + k, y1);
+                return idx(x0 + k, y0 - 1);
+            };
+            auto freeEdgeCell = [&](bool needEmpty) {
+                for (int attempt = 0; attempt < 4; ++attempt) {
+                    int i = edgeCell(std::uniform_int_distribution<int>(0, length - 1)(rng));
+                    auto const& c = std::as_const(grid_)[i];
+                    if (!c.animal && !isBlocked(i) && (!needEmpty || !c.plant)) return i;
+                }
+                return -1;
+            };
 
-                if (!dst.animal) {
-                    moves.push_back({ x, y, next.x, next.y });
+            for (bool herb : { true, false }) {
+                SpeciesField& s = herb ? f.herbivores : f.carnivores;
+                int n = roundStochastic((s.total() - s.babies()) / area * length * 0.25, rng);
+                for (int k = 0; k < n; ++k) {
+                    int i = freeEdgeCell(false);
+                    if (i < 0) continue;
+                    auto d = s.draw(rng, cfg_.satiety_after_eat);
+                    d.baby = 0;
+                    s.remove(d, cfg_.satiety_after_eat);
+                    Gender g = (rng() & 1) ? Gender::Female : Gender::Male;
+                    placeAnimal(i, makeDrawn(herb ? AnimalKind::Herbivore : AnimalKind::Carnivore, g, d, turn_));
                 }
             }
+
+            if (!isSpreadTurn()) continue;
+            int n = roundStochastic(f.plants / area * length * 0.25 * cfg_.plant_spread_chance_percent / 100.0, rng);
+            for (int k = 0; k < n && plantBudget >= 1.0; ++k) {
+                int i = freeEdgeCell(true);
+                if (i < 0) continue;
+                spawnPlant(i);
+                plantBudget -= 1.0;
+            }
         }
+    }
 
-        for (auto& m : moves) {
-            if (!grid_[idx(m.x, m.y)].animal) continue;
-            if (grid_[idx(m.nx, m.ny)].animal) continue;
+    void World::sysLevelOfDetail() {
+        LevelOfDetail& lod = *lod_;
+        lod.events() = {};
+        std::uint64_t before = hash_;
+        const int tiles = lod.tileCount();
+
+        double plantBudget = 0.0;
+        for (StepPhase stage : { StepPhase::LodAbsorb, StepPhase::LodDensity, StepPhase::LodModes })
+            levelOfDetailTiles(stage, 0, tiles, plantBudget);
+        plantBudget = lodPlantBudget();
+        levelOfDetailTiles(StepPhase::LodModel, 0, tiles, plantBudget);
+        levelOfDetailTiles(StepPhase::LodEmit, 0, tiles, plantBudget);
+
+        if (hash_ != before) rebuildOccupancy();
+    }
 
-            grid_[idx(m.nx, m.ny)].animal = std::move(grid_[idx(m.x, m.y)].animal);
+    void World::levelOfDetailTiles(StepPhase stage, int t0, int t1, double& plantBudget) {
+        LevelOfDetail& lod = *lod_;
+        const double threshold = lod.options().heterogeneity;
+        for (int t = t0; t < t1; ++t) {
+            bool aggregate = lod.mode(t) == TileMode::Aggregate;
+            switch (stage) {
+            case StepPhase::LodAbsorb:
+                if (aggregate) absorbTile(t);
+                break;
+            case StepPhase::LodDensity:
+                lodDensity_[t] = tileDensity(t);
+                break;
+            case StepPhase::LodModes: {
+                bool interest = lod.inInterest(t);
+                bool settled = lod.turnsInMode(t, turn_) >= lod.options().minTurnsInMode;
+                if (aggregate) {
+                    if (interest || (settled && tileHeterogeneous(t, threshold))) materializeTile(t);
+                }
+                else if (!interest && settled && !tileHeterogeneous(t, threshold / 2)) {
+                    aggregateTile(t);
+                }
+                break;
+            }
+            case StepPhase::LodModel:
+                if (aggregate) lod.model().step(lod.field(t), lod.area(t), isSpreadTurn(), plantBudget, lod.events());
+                break;
+            case StepPhase::LodEmit:
+                if (aggregate) emitMigrants(t, plantBudget);
+                break;
+            default:
+                break;
+            }
         }
     }
 
-    // Nourrissage
+    // Place laissee aux plantes, celles des tuiles agregees comprises.
+    double World::lodPlantBudget() const {
+        double plantBudget = cfg_.max_plant_percent * static_cast<double>(cfg_.width) * cfg_.height / 100.0
+            - plantCount_;
+        for (int t = 0; t < lod_->tileCount(); ++t)
+            if (lod_->mode(t) == TileMode::Aggregate) plantBudget -= lod_->field(t).plants;
+        return plantBudget;
+    }
 
-    void World::sysFeed() {
-        for (int y = 0; y < cfg_.height; y++)
-            for (int x = 0; x < cfg_.width; x++)
-                if (auto& a = grid_[idx(x, y)].animal)
-                    a->feeding().try_feed(*this, x, y);
+    std::uint64_t World::recomputeStateHash() const {
+        return hashRows(rowBegin_, rowEnd_);
     }
 
-    // Reproduction
+    std::uint64_t World::hashRows(int y0, int y1) const {
+        y0 = std::max(y0, rowBegin_);
+        y1 = std::min(y1, rowEnd_);
+
+        std::uint64_t h = 0;
+        forEachCell(y0, y1, [&](int x, int y, int i) {
+            auto const& c = grid_[i];
+            std::uint64_t key = static_cast<std::uint64_t>(y) * cfg_.width + x;
+            if (c.plant) h ^= StateHash::plant(key);
+            if (c.animal) h ^= StateHash::animal(key, *c.animal);
+        });
+        return h;
+    }
 
-    void World::sysReproduce() {
-        static const std::array<std::pair<int, int>, 4> dirs{ {{1,0},{-1,0},{0,1},{0,-1}} };
+    void World::rebuildOverview(OverviewPyramid& out) const {
+        out.reset(cfg_.width, rowEnd_ - rowBegin_);
+        forEachCell(rowBegin_, rowEnd_, [&](int x, int y, int i) {
+            auto const& c = grid_[i];
+            if (c.plant) out.addPlant(x, y - rowBegin_, 1);
+            if (c.animal) out.addAnimal(x, y - rowBegin_, *c.animal, 1);
+        });
+    }
 
-        for (int y = 0; y < cfg_.height; y++) {
-            for (int x = 0; x < cfg_.width; x++) {
+    bool World::verifyOverview() const {
+        OverviewPyramid fresh;
+        rebuildOverview(fresh);
+        return sameOverview(fresh);
+    }
 
-                auto& cell = grid_[idx(x, y)];
-                if (!cell.animal) continue;
-                auto& a = *cell.animal;
+    bool World::sameOverview(const OverviewPyramid& fresh) const {
+        for (int level = 0; level < fresh.levels(); ++level) {
+            for (int ty = 0; ty < fresh.tilesY(level); ++ty) {
+                for (int tx = 0; tx < fresh.tilesX(level); ++tx) {
+                    auto const& a = fresh.at(level, tx, ty);
+                    auto const& b = overview_.at(level, tx, ty);
+                    if (a.plants != b.plants || a.herbivores != b.herbivores
+                        || a.carnivores != b.carnivores || a.babies != b.babies) return false;
+                }
+            }
+        }
+        return true;
+    }
 
-                if (a.repro_cooldown_ref() > 0) continue;
+    // Tirage de Floyd : n indices distincts de [0, total). Les cases prises sont
+    // notees dans une table de hachage de n elements tant que n est petit devant
+    // total, dans un bit par case sinon (plus compact des n > total / 64). Indices
+    // en 64 bits : une grille peut depasser 2^31 cellules.
+    static std::vector<std::int64_t> sampleDistinct(int n, std::int64_t total, std::mt19937& rng) {
+        std::vector<std::int64_t> out;
+        out.reserve(n);
+
+        auto draw = [&](auto&& taken, auto&& take) {
+            for (std::int64_t j = total - n; j < total; ++j) {
+                std::int64_t t = std::uniform_int_distribution<std::int64_t>(0, j)(rng);
+                std::int64_t pick = taken(t) ? j : t;
+                take(pick);
+                out.push_back(pick);
+            }
+        };
+        if (n < total / 64) {
+            std::unordered_set<std::int64_t> taken;
+            taken.reserve(static_cast<std::size_t>(n));
+            draw([&](std::int64_t i) { return taken.count(i) != 0; }, [&](std::int64_t i) { taken.insert(i); });
+        }
+        else {
+            std::vector<bool> taken(static_cast<std::size_t>(total), false);
+            draw([&](std::int64_t i) { return taken[i]; }, [&](std::int64_t i) { taken[i] = true; });
+        }
+        return out;
+    }
 
-                for (auto [dx, dy] : dirs) {
-                    int nx = x + dx, ny = y + dy;
-                    if (!inBounds(nx, ny)) continue;
-                    auto& ncell = grid_[idx(nx, ny)];
-                    if (!ncell.animal) continue;
+    // Plafond en pourcentage des cellules, sans debordement sur les grandes grilles ;
+    // les effectifs de la configuration restent des int.
+    static int cellShare(std::int64_t totalCells, int percent) {
+        std::int64_t share = totalCells * std::clamp(percent, 0, 100) / 100;
+        return static_cast<int>(std::min<std::int64_t>(share, std::numeric_limits<int>::max()));
+    }
 
-                    auto& b = *ncell.animal;
+    static constexpr std::size_t kSeedChunk = 1 << 15;
+
+    void World::placeOnNodes() {
+        const Topology& topo = Topology::I();
+        if (topo.nodes() <= 1 || grid_.get_allocator().mapped()) return;
+        occupancy_->resize(cfg_.width, rowEnd_ - rowBegin_);
+
+        // Toute la grille : bandes de Topology::nodeOfRow. Un domaine : tout sur le
+        // noeud de sa bande, ou son thread est epingle (voir DomainWorker).
+        const bool whole = rowBegin_ == 0 && rowEnd_ == cfg_.height;
+        auto nodeOf = [&](int y) {
+            return topo.nodeOfRow(whole ? y : (rowBegin_ + rowEnd_) / 2, cfg_.height);
+        };
+
+        std::vector<std::thread> pool;
+        for (int y0 = rowBegin_; y0 < rowEnd_;) {
+            int node = nodeOf(y0);
+            int y1 = y0 + 1;
+            while (y1 < rowEnd_ && nodeOf(y1) == node) ++y1;
+            pool.emplace_back([this, &topo, node, y0, y1] {
+                topo.pinToNode(node);
+                auto span = storageSpan(y0, y1);
+                grid_.touch(static_cast<std::size_t>(span.first), static_cast<std::size_t>(span.second));
+                // Ligne k + 1 de la table pour la ligne k ; la ligne 0 va a la premiere bande.
+                occupancy_->touch(y0 == rowBegin_ ? 0 : y0 - rowBegin_ + 1, y1 - rowBegin_ + 1);
+            });
+            y0 = y1;
+        }
+        for (auto& t : pool) t.join();
+    }
 
-                    if (b.kind() == a.kind() &&
-                        b.repro_cooldown_ref() == 0 &&
-                        b.gender() != a.gender()) {
+    void World::seedPlants(int n, std::mt19937& rng) {
+        const std::int64_t totalCells = std::int64_t(cfg_.width) * cfg_.height;
+        n = std::clamp(n, 0, cellShare(totalCells, cfg_.max_plant_percent));
 
-                        bool spawned = false;
-                        for (auto [ex, ey] : dirs) {
-                            int bx = x + ex, by = y + ey;
-                            if (!inBounds(bx, by)) continue;
-                            auto& bcell = grid_[idx(bx, by)];
-                            if (!bcell.animal) {
-                                if (a.kind() == AnimalKind::Herbivore)
-                                    bcell.animal = EntityFactory::makeHerbivore();
-                                else
-                                    bcell.animal = EntityFactory::makeCarnivore();
+        std::vector<std::int64_t> cells = sampleDistinct(n, totalCells, rng);
+        const std::int64_t first = std::int64_t(rowBegin_) * cfg_.width;
+        const std::int64_t last = std::int64_t(rowEnd_) * cfg_.width;
 
-                                bcell.animal->baby_turns_ref() = cfg_.baby_stay_turns;
+        parallelFor(cells.size(), kSeedChunk, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                if (cells[i] < first || cells[i] >= last) continue;
+                grid_[idx(static_cast<int>(cells[i] % cfg_.width), static_cast<int>(cells[i] / cfg_.width))].plant = EntityFactory::makePlant();
+            }
+        });
+    }
+
+    void World::seedAnimals(int nHerbs, int nCarns, std::mt19937& rng) {
+        const std::int64_t totalCells = std::int64_t(cfg_.width) * cfg_.height;
+        nHerbs = std::clamp(nHerbs, 0, cellShare(totalCells, cfg_.max_herbivore_percent));
+        nCarns = std::clamp(nCarns, 0, cellShare(totalCells, cfg_.max_carnivore_percent));
+        nCarns = static_cast<int>(std::min<std::int64_t>(nCarns, totalCells - nHerbs));
+        nCarns = std::min(nCarns, std::numeric_limits<int>::max() - nHerbs);
+
+        // Un seul tirage pour les deux especes : les cellules sont distinctes par construction.
+        std::vector<std::int64_t> cells = sampleDistinct(nHerbs + nCarns, totalCells, rng);
+        std::shuffle(cells.begin(), cells.end(), rng);
+
+        std::vector<std::uint8_t> females(cells.size());
+        std::bernoulli_distribution coin(0.5);
+        for (auto& f : females) f = coin(rng) ? 1 : 0;
+
+        // Le tirage porte sur toute la grille ; seules les lignes stockees sont materialisees.
+        const std::int64_t first = std::int64_t(rowBegin_) * cfg_.width;
+        const std::int64_t last = std::int64_t(rowEnd_) * cfg_.width;
+
+        parallelFor(cells.size(), kSeedChunk, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                if (cells[i] < first || cells[i] >= last) continue;
+                Gender g = females[i] ? Gender::Female : Gender::Male;
+                grid_[idx(static_cast<int>(cells[i] % cfg_.width), static_cast<int>(cells[i] / cfg_.width))].animal = (static_cast<int>(i) < nHerbs)
+                    ? EntityFactory::makeHerbivore(g)
+                    : EntityFactory::makeCarnivore(g);
+            }
+        });
+    }
 
-                                a.repro_cooldown_ref() = cfg_.repro_cool_down;
-                                b.repro_cooldown_ref() = cfg_.repro_cool_down;
+    // Carte d'habitat : un tirage par cellule et par flux, fonction de (graine, cellule)
+    // comme ceux de la simulation ; les domaines tirent donc les memes cellules et les
+    // bandes de lignes se peuplent en parallele. Probabilites en seuils sur 32 bits.
+    void World::seedHabitat(const HabitatMap& map) {
+        auto thresholds = [](int percent) {
+            std::array<std::uint64_t, 256> t{};
+            for (int v = 0; v < 256; ++v)
+                t[v] = (std::uint64_t(v) * std::clamp(percent, 0, 100) << 32) / (255 * 100);
+            return t;
+        };
+        const auto plantAt = thresholds(cfg_.max_plant_percent);
+        const auto herbAt = thresholds(cfg_.max_herbivore_percent);
+        const auto carnAt = thresholds(cfg_.max_carnivore_percent);
+        const std::uint64_t key = counterKey(static_cast<std::uint64_t>(cfg_.seed), 0);
+
+        // Pixel le plus proche si l'image n'a pas les dimensions de la grille.
+        auto texel = [&](int x, int y) {
+            return map.at(static_cast<int>(std::int64_t(x) * map.width() / cfg_.width),
+                static_cast<int>(std::int64_t(y) * map.height() / cfg_.height));
+        };
+
+        // Bits par mots entiers : a faire avant de peupler, sur un seul thread.
+        if (map.hasBlocked()) {
+            blocked_.assign((grid_.size() + 63) / 64, 0);
+            forEachCell(rowBegin_, rowEnd_, [&](int x, int y, int i) {
+                if (texel(x, y).blocked) blocked_[i >> 6] |= std::uint64_t(1) << (i & 63);
+            });
+        }
 
-                                spawned = true;
-                                break;
-                            }
-                        }
-                        if (spawned) break;
+        const int rows = rowEnd_ - rowBegin_;
+        const std::size_t rowsPerChunk = std::max<std::size_t>(1, kSeedChunk / std::max(1, cfg_.width));
+        parallelFor(static_cast<std::size_t>(rows), rowsPerChunk, [&](std::size_t begin, std::size_t end) {
+            for (int y = rowBegin_ + static_cast<int>(begin); y < rowBegin_ + static_cast<int>(end); ++y) {
+                for (int x = 0; x < cfg_.width; ++x) {
+                    HabitatMap::Texel t = texel(x, y);
+                    if (t.blocked) continue;
+                    auto cell = static_cast<std::uint64_t>(y) * cfg_.width + x;
+                    Cell& c = grid_[idx(x, y)];
+                    if (counterRandomKeyed(key, RandomStream::HabitatPlant, cell) < plantAt[t.plant]) {
+                        c.plant = EntityFactory::makePlant();
                     }
+                    std::uint64_t r = counterRandomKeyed(key, RandomStream::HabitatAnimal, cell);
+                    if (r >= herbAt[t.herbivore] + carnAt[t.carnivore]) continue;
+                    Gender g = (counterRandomKeyed(key, RandomStream::HabitatGender, cell) & 1) ? Gender::Female : Gender::Male;
+                    c.animal = r < herbAt[t.herbivore] ? EntityFactory::makeHerbivore(g) : EntityFactory::makeCarnivore(g);
                 }
             }
-        }
+        });
     }
 
-    // Propagation des plantes
+    // D�placements
 
-    void World::sysPlantsSpread() {
+    void World::sysMove() {
+        moves_.clear();
+        decideMoves(rowBegin_, rowEnd_);
+        applyMoves();
+    }
+
+    // Les decisions lisent l'etat du debut de tour ; rien n'est modifie ici.
+    void World::decideMoves(int y0, int y1) {
+        moves_.reserve(countSet(mobile_, y0, y1));
 
-        if (turn_ == 0) return;
+        // Seuls les adultes bougent.
+        forEachSet(mobile_, y0, y1, [&](int x, int y, int i) { decideMove(x, y, i); });
+    }
 
-        if (turn_ % cfg_.plant_spread_period != 0) return;
+    void World::decideMove(int x, int y, int i) {
+        auto& a = *std::as_const(grid_)[i].animal;
 
-        int totalCells = cfg_.width * cfg_.height;
-        int plantCount = 0;
-        for (auto const& c : grid_) {
-            if (c.plant) plantCount++;
+        auto next = a.movement().choose_next(*this, x, y);
+
+        if (!inBounds(next.x, next.y)) return;
+
+        auto const& dst = std::as_const(grid_)[idx(next.x, next.y)];
+
+        if (!dst.animal && !isBlocked(idx(next.x, next.y))) {
+            moves_.push_back({ x, y, next.x, next.y });
         }
+    }
 
-        if (plantCount * 100 >= cfg_.max_plant_percent * totalCells) {
-            return;
+    void World::applyMoves() {
+        applyMoves(0, moves_.size());
+        moves_.clear();
+    }
+
+    void World::applyMoves(std::size_t first, std::size_t last) {
+        for (std::size_t k = first; k < last; ++k) {
+            auto& m = moves_[k];
+            if (!std::as_const(grid_)[idx(m.x, m.y)].animal) continue;
+            if (std::as_const(grid_)[idx(m.nx, m.ny)].animal) continue;
+
+            moveAnimal(idx(m.x, m.y), idx(m.nx, m.ny));
         }
+    }
 
-        std::vector<std::pair<int, int>> pos;
-        pos.reserve(plantCount);
-        for (int y = 0; y < cfg_.height; ++y) {
-            for (int x = 0; x < cfg_.width; ++x) {
-                if (grid_[idx(x, y)].plant) {
-                    pos.emplace_back(x, y);
+    // Nourrissage
+
+    void World::sysFeed() {
+        feedRows(rowBegin_, rowEnd_);
+    }
+
+    void World::feedRows(int y0, int y1) {
+        forEachCell(y0, y1, [&](int x, int y, int i) { feedCell(x, y, i); });
+    }
+
+    void World::feedCell(int x, int y, int i) {
+        if (auto const& a = std::as_const(grid_)[i].animal)
+            a->feeding().try_feed(*this, x, y);
+    }
+
+    // Reproduction
+
+    void World::sysReproduce() {
+        reproduceRows(rowBegin_, rowEnd_);
+    }
+
+    void World::reproduceRows(int y0, int y1) {
+        // Animaux sans repos en cours, y compris les nouveau-nes poses plus loin dans le parcours.
+        forEachSet(ready_, y0, y1, [&](int x, int y, int i) { reproduceCell(x, y, i); });
+    }
+
+    void World::reproduceCell(int x, int y, int i) {
+        static const std::array<std::pair<int, int>, 4> dirs{ {{1,0},{-1,0},{0,1},{0,-1}} };
+
+        auto& a = *std::as_const(grid_)[i].animal;
+
+        forEachNeighbor(x, y, [&](const Cell& ncell, int nx, int ny) {
+            if (!ncell.animal) return false;
+
+            auto& b = *ncell.animal;
+
+            if (b.kind() == a.kind() &&
+                b.timers().cooldown(turn_) == 0 &&
+                b.gender() != a.gender()) {
+
+                bool spawned = false;
+                for (auto [ex, ey] : dirs) {
+                    int bx = x + ex, by = y + ey;
+                    if (!inBounds(bx, by)) continue;
+                    auto const& bcell = std::as_const(grid_)[idx(bx, by)];
+                    if (!bcell.animal && !isBlocked(idx(bx, by))) {
+                        Gender g = randomInt(RandomStream::BirthGender, bx, by, 2) == 0
+                            ? Gender::Male : Gender::Female;
+                        std::unique_ptr<IAnimal> baby = (a.kind() == AnimalKind::Herbivore)
+                            ? EntityFactory::makeHerbivore(g)
+                            : EntityFactory::makeCarnivore(g);
+
+                        // +1 : le tour de naissance compte deja parmi les tours de bebe.
+                        baby->timers().hungryAt = turn_;
+                        baby->timers().adultAt = turn_ + cfg_.baby_stay_turns + 1;
+                        AnimalHandle pa = handleAt(x, y), pb = handleAt(nx, ny);
+                        spawnAnimal(idx(bx, by), std::move(baby));
+                        AnimalSlot& born = animalSlots_[std::as_const(grid_)[idx(bx, by)].animal->timers().slot];
+                        born.mother = a.gender() == Gender::Female ? pa : pb;
+                        born.father = a.gender() == Gender::Female ? pb : pa;
+
+                        setReproCooldown(i, cfg_.repro_cool_down);
+                        setReproCooldown(idx(nx, ny), cfg_.repro_cool_down);
+
+                        spawned = true;
+                        break;
+                    }
                 }
+                if (spawned) return true;
+            }
+            return false;
+        });
+    }
+
+    // Propagation des plantes
+
+    void World::sysPlantsSpread() {
+        if (!isSpreadTurn()) return;
+
+        collectSpreadSources(rowBegin_, rowEnd_);
+        spreadPlants(countPlants(rowBegin_, rowEnd_) + aggregatePlants());
+    }
+
+    bool World::isSpreadTurn() const {
+        return turn_ != 0 && turn_ % cfg_.plant_spread_period == 0;
+    }
+
+    int World::countPlants(int y0, int y1) const {
+        if (y0 <= rowBegin_ && y1 >= rowEnd_) return plantCount_;
+
+        int n = 0;
+        forEachCell(y0, y1, [&](int, int, int i) {
+            if (grid_[i].plant) n++;
+        });
+        return n;
+    }
+
+    // Une plante sans voisine vide ne peut rien faire naitre, et la propagation ne fait
+    // que remplir des cases : seule la frontiere est parcourue, dans l'ordre de la disposition.
+    void World::collectSpreadSources(int y0, int y1) {
+        spreadSources_.clear();
+        spreadSources_.reserve(countSet(frontier_, y0, y1));
+        auto [first, last] = storageSpan(y0, y1);
+        appendSpreadSources(first, last, y0, y1);
+    }
+
+    void World::appendSpreadSources(int first, int last, int y0, int y1) {
+        for (int w = first >> 6; w < (last + 63) >> 6; ++w) {
+            std::uint64_t bits = std::as_const(frontier_)[w];
+            while (bits) {
+                int i = (w << 6) + std::countr_zero(bits);
+                bits &= bits - 1;
+                if (i < first || i >= last) continue;
+                int x, y;
+                positionOf(i, x, y);
+                if (y < y0 || y >= y1) continue;
+                spreadSources_.emplace_back(x, y);
             }
         }
+    }
+
+    // plantCount est le total global au debut de la propagation ; renvoie le total mis a jour.
+    int World::spreadPlants(int plantCount) {
+        return spreadPlants(plantCount, 0, spreadSources_.size());
+    }
+
+    int World::spreadPlants(int plantCount, std::size_t first, std::size_t last) {
+        // En 64 bits : max_plant_percent * cellules deborde d'un int des 54 M de cellules.
+        const std::int64_t cap = std::int64_t(cfg_.max_plant_percent) * cfg_.width * cfg_.height;
+
+        if (std::int64_t(plantCount) * 100 >= cap) {
+            return plantCount;
+        }
 
         static const std::array<std::pair<int, int>, 4> dirs{ {
             {  1,  0},
@@ -228,56 +1259,479 @@ namespace Ecosystem {
             {  0, -1}
         } };
 
-        for (auto [x, y] : pos) {
+        for (std::size_t k = first; k < last; ++k) {
+            auto [x, y] = spreadSources_[k];
 
-            auto [dx, dy] = dirs[std::rand() % 4];
+            auto [dx, dy] = dirs[randomInt(RandomStream::SpreadDirection, x, y, 4)];
             int nx = x + dx;
             int ny = y + dy;
 
             if (!inBounds(nx, ny)) continue;
 
-            auto& c = grid_[idx(nx, ny)];
+            auto const& c = std::as_const(grid_)[idx(nx, ny)];
 
-            if (!c.plant && !c.animal) {
+            if (!c.plant && !c.animal && !isBlocked(idx(nx, ny))) {
 
-                int r = std::rand() % 100;
+                int r = randomInt(RandomStream::SpreadChance, x, y, 100);
                 if (r < cfg_.plant_spread_chance_percent) {
-                    c.plant = EntityFactory::makePlant();
+                    spawnPlant(idx(nx, ny));
                     plantCount++;
 
-                    if (plantCount * 100 >= cfg_.max_plant_percent * totalCells) {
+                    if (std::int64_t(plantCount) * 100 >= cap) {
                         break;
                     }
                 }
             }
         }
+        return plantCount;
+    }
+
+
+    // Tour fusionne
+
+    // Assez courtes pour que les bandes en vol tiennent dans kFusedBytes ; en
+    // disposition Tiled, un rang de blocs, pour suivre l'ordre du parcours complet.
+    int World::fusedRows() const {
+        if (layout_ == GridLayout::Tiled) return TiledGrid::kBlock;
+
+        std::size_t rowBytes = static_cast<std::size_t>(cfg_.width) * kFusedCellBytes;
+        int rows = TiledGrid::kBlock;
+        while (rows > 4) {
+            int inFlight = 1 + fusedLag(PaddedGrid::kMargin + 1, rows) + 2 * fusedLag(2, rows);
+            if (static_cast<std::size_t>(inFlight) * rows * rowBytes <= kFusedBytes) break;
+            rows /= 2;
+        }
+        return rows;
     }
 
+    // Portees : les decisions lisent jusqu'a PaddedGrid::kMargin lignes (fenetres des
+    // strategies, la table d'occupation ne change pas pendant le tour) ; un deplacement,
+    // un repas ou une naissance lit et ecrit les voisines, a une ligne. Les deplacements
+    // d'une bande sont a la suite dans moves_, toujours appliques dans l'ordre.
+    void World::sysFused() {
+        const int rows = fusedRows();
+        const int lagApply = fusedLag(PaddedGrid::kMargin + 1, rows);
+        const int lagFeed = lagApply + fusedLag(2, rows);
+        const int lagReproduce = lagFeed + fusedLag(2, rows);
+        const int bands = (rowEnd_ - rowBegin_ + rows - 1) / rows;
+
+        auto bandRows = [&](int b, int& y0, int& y1) {
+            y0 = rowBegin_ + b * rows;
+            y1 = std::min(y0 + rows, rowEnd_);
+            return b >= 0 && b < bands;
+        };
+
+        moves_.clear();
+        moves_.reserve(countSet(mobile_, rowBegin_, rowEnd_));
+        std::size_t applied = 0;
+
+        for (int k = 0; k < bands + lagReproduce; ++k) {
+            int y0, y1;
+            if (bandRows(k, y0, y1)) {
+                PerfSection p(PerfScope::Move);
+                decideMoves(y0, y1);
+            }
+            if (bandRows(k - lagApply, y0, y1)) {
+                PerfSection p(PerfScope::Move);
+                std::size_t last = applied;
+                while (last < moves_.size() && moves_[last].y < y1) ++last;
+                applyMoves(applied, last);
+                applied = last;
+            }
+            if (bandRows(k - lagFeed, y0, y1)) {
+                PerfSection p(PerfScope::Feed);
+                feedRows(y0, y1);
+            }
+            if (bandRows(k - lagReproduce, y0, y1)) {
+                PerfSection p(PerfScope::Reproduce);
+                reproduceRows(y0, y1);
+            }
+        }
+        moves_.clear();
+    }
 
-    // Vieillissement & faim
+    // Vieillissement & faim : seuls les reveils du tour sont traites, le cout suit le
+    // nombre de transitions et non la population.
 
     void World::sysAgingAndStarvation() {
-        for (int y = 0; y < cfg_.height; y++) {
-            for (int x = 0; x < cfg_.width; x++) {
-                auto& c = grid_[idx(x, y)];
-                if (c.plant) c.plant->age_one_trun();
+        fireTimers(rowBegin_, rowEnd_);
+    }
+
+    // Un reveil n'est retenu que si l'echeance qu'il porte est encore celle de
+    // l'animal : un repas repousse la faim sans rien reprogrammer, le reveil de faim
+    // qui arrive trop tot se reprogramme a la nouvelle echeance.
+    void World::fireTimers(int y0, int y1) {
+        timers_.advance([&](const TimerEntry& e) { fireTimer(e, y0, y1); });
+    }
+
+    void World::fireTimer(const TimerEntry& e, int y0, int y1) {
+        if (animalSlots_[e.slot].generation != e.generation) return;
+        int i = animalSlots_[e.slot].cell;
+        int x, y;
+        positionOf(i, x, y);
+        if (y < y0 || y >= y1) return;
+
+        IAnimal& a = *grid_[i].animal;
+        AnimalTimers& t = a.timers();
+        switch (e.kind) {
+        case TimerKind::Adult:
+            if (t.adultAt != e.due) break;
+            hash_ ^= StateHash::animal(cellKey(i), a);
+            t.adultAt = 0;
+            hash_ ^= StateHash::animal(cellKey(i), a);
+            overview_.addBaby(x, y - rowBegin_, -1);
+            setBit(mobile_, i, true);
+            break;
+        case TimerKind::Rested:
+            if (t.cooldownEnd != e.due) break;
+            hash_ ^= StateHash::animal(cellKey(i), a);
+            t.cooldownEnd = 0;
+            hash_ ^= StateHash::animal(cellKey(i), a);
+            setBit(ready_, i, true);
+            break;
+        case TimerKind::Starving:
+            if (t.hunger(turn_) < cfg_.starvation_limit) {
+                schedule(e.slot, TimerKind::Starving, starvationTurn(t));
+                break;
+            }
+            hash_ ^= StateHash::animal(cellKey(i), a);
+            overview_.addAnimal(x, y - rowBegin_, a, -1);
+            releaseAnimal(i);
+            grid_[i].animal.reset();
+            touchFrontier(i);
+            deaths_++;
+            break;
+        }
+    }
+
+    // Echange de lignes : drapeaux par cellule, puis les echeances si un animal est present.
+
+    enum CellBits : std::uint8_t {
+        HasPlant = 1,
+        HasAnimal = 2,
+        IsCarnivore = 4,
+        IsFemale = 8
+    };
+
+    template <class T>
+    static void putRaw(std::vector<std::uint8_t>& out, T v) {
+        auto* p = reinterpret_cast<const std::uint8_t*>(&v);
+        out.insert(out.end(), p, p + sizeof(T));
+    }
+
+    template <class T>
+    static T getRaw(const std::uint8_t*& p) {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return v;
+    }
+
+    void World::encodeRows(int y0, int y1, std::vector<std::uint8_t>& out) const {
+        y0 = std::max(y0, rowBegin_);
+        y1 = std::min(y1, rowEnd_);
+        putRaw<std::int32_t>(out, y0);
+        putRaw<std::int32_t>(out, std::max(y0, y1));
+
+        for (int y = y0; y < y1; ++y) {
+            for (int x = 0; x < cfg_.width; ++x) {
+                auto const& c = grid_[idx(x, y)];
+                std::uint8_t bits = 0;
+                if (c.plant) bits |= HasPlant;
                 if (c.animal) {
-                    auto& a = *c.animal;
-                    a.on_step_begin();
-                    if (a.hungery_ref() >= cfg_.starvation_limit)
-                        c.animal.reset();
+                    bits |= HasAnimal;
+                    if (c.animal->kind() == AnimalKind::Carnivore) bits |= IsCarnivore;
+                    if (c.animal->gender() == Gender::Female) bits |= IsFemale;
+                }
+                out.push_back(bits);
+                if (c.animal) {
+                    const AnimalTimers& t = c.animal->timers();
+                    putRaw<std::int32_t>(out, t.hungryAt);
+                    putRaw<std::int32_t>(out, t.cooldownEnd);
+                    putRaw<std::int32_t>(out, t.adultAt);
+                }
+            }
+        }
+    }
+
+    void World::decodeRows(const std::uint8_t* data, std::size_t size) {
+        const std::uint8_t* p = data;
+        const std::uint8_t* end = data + size;
+
+        while (p < end) {
+            int y0 = getRaw<std::int32_t>(p);
+            int y1 = getRaw<std::int32_t>(p);
+
+            for (int y = y0; y < y1; ++y) {
+                for (int x = 0; x < cfg_.width; ++x) {
+                    std::uint8_t bits = *p++;
+                    std::unique_ptr<IAnimal> animal;
+                    if (bits & HasAnimal) {
+                        Gender g = (bits & IsFemale) ? Gender::Female : Gender::Male;
+                        animal = (bits & IsCarnivore) ? EntityFactory::makeCarnivore(g)
+                                                      : EntityFactory::makeHerbivore(g);
+                        AnimalTimers& t = animal->timers();
+                        t.hungryAt = getRaw<std::int32_t>(p);
+                        t.cooldownEnd = getRaw<std::int32_t>(p);
+                        t.adultAt = getRaw<std::int32_t>(p);
+                        // Les halos de l'emetteur ne traitent pas leurs reveils : echeances passees remises a 0.
+                        if (t.cooldownEnd <= turn_) t.cooldownEnd = 0;
+                        if (t.adultAt <= turn_) t.adultAt = 0;
+                    }
+                    if (!inBounds(x, y)) continue;
+
+                    int i = idx(x, y);
+                    auto& c = grid_[i];
+                    if (c.plant) hash_ ^= StateHash::plant(cellKey(i));
+                    if (c.animal) hash_ ^= StateHash::animal(cellKey(i), *c.animal);
+                    if (c.plant) overview_.addPlant(x, y - rowBegin_, -1);
+                    if (c.animal) overview_.addAnimal(x, y - rowBegin_, *c.animal, -1);
+                    if (c.animal) releaseAnimal(i);
+
+                    if ((bits & HasPlant) && !c.plant) {
+                        c.plant = EntityFactory::makePlant(turn_);
+                        plantCount_++;
+                    }
+                    if (!(bits & HasPlant) && c.plant) {
+                        c.plant.reset();
+                        plantCount_--;
+                    }
+                    c.animal = std::move(animal);
+                    if (c.animal) adoptAnimal(i);
+                    touchFrontier(i);
+
+                    if (c.plant) hash_ ^= StateHash::plant(cellKey(i));
+                    if (c.animal) hash_ ^= StateHash::animal(cellKey(i), *c.animal);
+                    if (c.plant) overview_.addPlant(x, y - rowBegin_, 1);
+                    if (c.animal) overview_.addAnimal(x, y - rowBegin_, *c.animal, 1);
                 }
             }
         }
     }
 
     void World::step() {
-        sysMove();
-        sysFeed();
-        sysReproduce();
-        sysPlantsSpread();
-        sysAgingAndStarvation();
+        if (inTurn()) {
+            while (!stepSlice()) {}
+            return;
+        }
+        beginTurn();
+
+        if (lod_) { PerfSection p(PerfScope::LevelOfDetail); sysLevelOfDetail(); }
+        holdReleasedSlots(true);
+        if (cfg_.fused_step) {
+            sysFused();
+        }
+        else {
+            { PerfSection p(PerfScope::Move); sysMove(); }
+            { PerfSection p(PerfScope::Feed); sysFeed(); }
+            { PerfSection p(PerfScope::Reproduce); sysReproduce(); }
+        }
+        holdReleasedSlots(false);
+        { PerfSection p(PerfScope::Spread); sysPlantsSpread(); }
         turn_++;
+        { PerfSection p(PerfScope::Aging); sysAgingAndStarvation(); }
+        { PerfSection p(PerfScope::Occupancy); rebuildOccupancy(); }
+
+        endTurn();
+    }
+
+    void World::beginTurn() {
+        cursor_.allocsBefore = MemoryStats::I().totalAllocations();
+        births_ = deaths_ = kills_ = 0;
+    }
+
+    void World::endTurn() {
+        if (cfg_.verify_state_hash) {
+            OverviewPyramid fresh;
+            rebuildOverview(fresh);
+            checkRecomputed(recomputeStateHash(), fresh);
+        }
+        finishTurn();
+    }
+
+    void World::checkRecomputed(std::uint64_t hash, const OverviewPyramid& fresh) {
+        if (hash != hash_) {
+            std::cerr << "Hash d'etat incoherent au tour " << turn_ << "\n";
+            hash_ = hash;
+        }
+        if (!sameOverview(fresh)) {
+            std::cerr << "Pyramide d'apercu incoherente au tour " << turn_ << "\n";
+            rebuildOverview(overview_);
+        }
+    }
+
+    void World::finishTurn() {
+        endFrame();
+        allocationsLastTurn_ = MemoryStats::I().totalAllocations() - cursor_.allocsBefore;
+        if (PerfCounters::I().enabled()) PerfCounters::I().endTurn();
+    }
+
+    // Tour decoupe
+
+    bool World::stepUntil(std::chrono::steady_clock::time_point deadline) {
+        do {
+            if (stepSlice()) return true;
+        } while (std::chrono::steady_clock::now() < deadline);
+        return false;
+    }
+
+    // Travail d'entree de phase, borne par le nombre de tuiles ou de mots de bits ;
+    // les phases sans rien a faire sont sautees.
+    void World::enterPhase(StepPhase phase) {
+        StepCursor& c = cursor_;
+        c.phase = phase;
+        c.row = rowBegin_;
+        c.item = 0;
+        switch (phase) {
+        case StepPhase::LodAbsorb:
+            lod_->events() = {};
+            c.hash = hash_;
+            break;
+        case StepPhase::LodModel:
+            c.plantBudget = lodPlantBudget();
+            break;
+        case StepPhase::LodOccupancy:
+            if (hash_ == c.hash) return enterPhase(StepPhase::Decide);
+            beginOccupancy();
+            break;
+        case StepPhase::Decide:
+            holdReleasedSlots(true);
+            moves_.clear();
+            moves_.reserve(countSet(mobile_, rowBegin_, rowEnd_));
+            break;
+        case StepPhase::Collect:
+            holdReleasedSlots(false);
+            if (!isSpreadTurn()) return enterPhase(StepPhase::Aging);
+            spreadSources_.clear();
+            spreadSources_.reserve(countSet(frontier_, rowBegin_, rowEnd_));
+            c.plants = countPlants(rowBegin_, rowEnd_) + aggregatePlants();
+            break;
+        case StepPhase::Aging:
+            turn_++;
+            timers_.beginAdvance();
+            break;
+        case StepPhase::Occupancy:
+            beginOccupancy();
+            break;
+        case StepPhase::Verify:
+            c.hash = 0;
+            if (cfg_.verify_state_hash) verifyScratch_.reset(cfg_.width, rowEnd_ - rowBegin_);
+            break;
+        default:
+            break;
+        }
+    }
+
+    bool World::stepSlice() {
+        StepCursor& c = cursor_;
+        if (c.phase == StepPhase::Idle) {
+            beginTurn();
+            enterPhase(lod_ ? StepPhase::LodAbsorb : StepPhase::Decide);
+        }
+
+        const int end = storageEnd();
+        const int cellsEnd = static_cast<int>(std::min<std::size_t>(c.item + kSliceCells, end));
+        const int y1 = std::min(c.row + std::max(1, kSliceCells / cfg_.width), rowEnd_);
+        std::size_t first = c.item;
+        switch (c.phase) {
+        case StepPhase::LodAbsorb:
+        case StepPhase::LodDensity:
+        case StepPhase::LodModes:
+        case StepPhase::LodModel:
+        case StepPhase::LodEmit: {
+            PerfSection p(PerfScope::LevelOfDetail);
+            const int tiles = lod_->tileCount();
+            int t0 = static_cast<int>(first), t1 = t0;
+            for (int cells = 0; t1 < tiles && cells < kSliceCells; ++t1) cells += lod_->area(t1);
+            levelOfDetailTiles(c.phase, t0, t1, c.plantBudget);
+            c.item = t1;
+            if (t1 >= tiles) enterPhase(static_cast<StepPhase>(static_cast<int>(c.phase) + 1));
+            break;
+        }
+        case StepPhase::LodOccupancy:
+            { PerfSection p(PerfScope::LevelOfDetail); occupancyRows(c.row, y1); }
+            c.row = y1;
+            if (y1 >= rowEnd_) enterPhase(StepPhase::Decide);
+            break;
+        case StepPhase::Decide:
+            { PerfSection p(PerfScope::Move);
+              c.item = forEachSetFrom(mobile_, c.item, kSliceAnimals, [&](int x, int y, int i) { decideMove(x, y, i); }); }
+            if (c.item >= static_cast<std::size_t>(end)) enterPhase(StepPhase::Apply);
+            break;
+        case StepPhase::Apply:
+            c.item = std::min(first + kSliceItems, moves_.size());
+            { PerfSection p(PerfScope::Move); applyMoves(first, c.item); }
+            if (c.item >= moves_.size()) {
+                moves_.clear();
+                enterPhase(StepPhase::Feed);
+            }
+            break;
+        case StepPhase::Feed:
+            { PerfSection p(PerfScope::Feed);
+              forEachStored(c.item, cellsEnd, [&](int x, int y, int i) { feedCell(x, y, i); }); }
+            c.item = cellsEnd;
+            if (cellsEnd >= end) enterPhase(StepPhase::Reproduce);
+            break;
+        case StepPhase::Reproduce:
+            { PerfSection p(PerfScope::Reproduce);
+              c.item = forEachSetFrom(ready_, c.item, kSliceAnimals, [&](int x, int y, int i) { reproduceCell(x, y, i); }); }
+            if (c.item >= static_cast<std::size_t>(end)) enterPhase(StepPhase::Collect);
+            break;
+        case StepPhase::Collect:
+            { PerfSection p(PerfScope::Spread); appendSpreadSources(c.item, cellsEnd, rowBegin_, rowEnd_); }
+            c.item = cellsEnd;
+            if (cellsEnd >= end) enterPhase(StepPhase::Spread);
+            break;
+        case StepPhase::Spread:
+            c.item = std::min(first + kSliceItems, spreadSources_.size());
+            { PerfSection p(PerfScope::Spread); c.plants = spreadPlants(c.plants, first, c.item); }
+            if (c.item >= spreadSources_.size()) enterPhase(StepPhase::Aging);
+            break;
+        case StepPhase::Aging: {
+            PerfSection p(PerfScope::Aging);
+            if (timers_.fireDue([&](const TimerEntry& e) { fireTimer(e, rowBegin_, rowEnd_); }, kSliceItems)) {
+                enterPhase(StepPhase::Occupancy);
+            }
+            break;
+        }
+        case StepPhase::Occupancy:
+            { PerfSection p(PerfScope::Occupancy); occupancyRows(c.row, y1); }
+            c.row = y1;
+            if (y1 >= rowEnd_) enterPhase(StepPhase::Verify);
+            break;
+        case StepPhase::Verify:
+            if (cfg_.verify_state_hash) {
+                // Meme cle et memes ajouts que hashRows et rebuildOverview.
+                forEachStored(c.item, cellsEnd, [&](int x, int y, int i) {
+                    auto const& cell = std::as_const(grid_)[i];
+                    std::uint64_t key = static_cast<std::uint64_t>(y) * cfg_.width + x;
+                    if (cell.plant) {
+                        c.hash ^= StateHash::plant(key);
+                        verifyScratch_.addPlant(x, y - rowBegin_, 1);
+                    }
+                    if (cell.animal) {
+                        c.hash ^= StateHash::animal(key, *cell.animal);
+                        verifyScratch_.addAnimal(x, y - rowBegin_, *cell.animal, 1);
+                    }
+                });
+                c.item = cellsEnd;
+                if (cellsEnd < end) break;
+                checkRecomputed(c.hash, verifyScratch_);
+            }
+            finishTurn();
+            c.phase = StepPhase::Idle;
+            return true;
+        case StepPhase::Idle:
+            break;
+        }
+        return false;
+    }
+
+    void World::endFrame() {
+        releaseFrame(moves_);
+        releaseFrame(spreadSources_);
+        releaseFrame(lodCells_);
+        frame_.reset();
     }
 
     std::string World::serialize(int turn) const {
@@ -307,7 +1761,7 @@ namespace Ecosystem {
 
         if (c.animal) {
             auto& a = *c.animal;
-            bool isBaby = (a.baby_turns_ref() > 0);
+            bool isBaby = (a.timers().babyTurns(turn_) > 0);
             bool isMale = (a.gender() == Gender::Male);
 
             if (a.kind() == AnimalKind::Herbivore) {
@@ -332,10 +1786,11 @@ namespace Ecosystem {
     }
 
     void World::print(int debugX, int debugY) const {
-        for (int y = 0; y < cfg_.height; ++y) {
+        PerfSection perf(PerfScope::Render);
+        for (int y = rowBegin_; y < rowEnd_; ++y) {
             for (int x = 0; x < cfg_.width; ++x) {
                 const Cell& c = grid_[idx(x, y)];
-                char ch = charForCell(c);
+                char ch = isBlocked(idx(x, y)) ? '#' : charForCell(c);
                 const char* col = color_for_char(ch);
 
                 bool isDebug = (x == debugX && y == debugY);
@@ -360,56 +1815,248 @@ namespace Ecosystem {
             << "  " << color_for_char('C') << "C" << RESET << " = carnivore adulte femelle\n"
             << "  " << color_for_char('M') << "M" << RESET << " = baby carnivore male\n"
             << "  " << color_for_char('F') << "F" << RESET << " = baby carnivore femelle\n"
-            << "  " << color_for_char('.') << "." << RESET << " = vide\n\n";
+            << "  " << color_for_char('.') << "." << RESET << " = vide\n";
+        if (blocked_.size() != 0) std::cout << "  # = infranchissable\n";
+        std::cout << "\n";
 
 
     }
 
-    std::string World::statsLine(int turn) const {
-        int plants = 0;
-        int herbTotal = 0, carnTotal = 0;
+    // Apercu : l'espece la plus marquante (densite ponderee) et un glyphe de densite.
+    static void overviewGlyph(const TileCounts& n, int area, const char*& color, char& glyph) {
+        static const char kRamp[] = ":-=+*#%@";
+        double plants = static_cast<double>(n.plants) / area;
+        double herbs = 3.0 * n.herbivores / area;
+        double carns = 3.0 * n.carnivores / area;
+        double score = std::max({ plants, herbs, carns });
+        if (score <= 0.0) {
+            color = RESET;
+            glyph = '.';
+            return;
+        }
+        glyph = kRamp[std::min(7, static_cast<int>(score * 8))];
+        if (carns >= score) color = RED;
+        else if (herbs >= score) color = CYAN;
+        else color = GREEN;
+        if (plants < score && n.babies * 2 > n.herbivores + n.carnivores) color = LightRed;
+    }
 
-        int babyHerbMale = 0;
-        int babyHerbFemale = 0;
-        int babyCarnMale = 0;
-        int babyCarnFemale = 0;
+    void World::printView(View view) const {
+        PerfSection perf(PerfScope::Render);
+        const int height = rowEnd_ - rowBegin_;
+        const int zoom = static_cast<int>(std::bit_ceil(static_cast<unsigned>(std::max(1, view.zoom))));
+        // Alignee sur le zoom : a partir de 4, chaque caractere est exactement une tuile de la pyramide.
+        int x0 = std::clamp(view.x, 0, std::max(0, cfg_.width - 1)) / zoom * zoom;
+        int y0 = std::clamp(view.y - rowBegin_, 0, std::max(0, height - 1)) / zoom * zoom;
+        int level = std::bit_width(static_cast<unsigned>(zoom)) - 1 - OverviewPyramid::kBaseBits;
+
+        std::cout << "Vue " << x0 << "," << (y0 + rowBegin_) << " zoom 1/" << zoom << "\n";
+        for (int r = 0; r < view.rows; ++r) {
+            int y = y0 + r * zoom;
+            if (y >= height) break;
+            for (int c = 0; c < view.columns; ++c) {
+                int x = x0 + c * zoom;
+                if (x >= cfg_.width) break;
+
+                if (zoom == 1) {
+                    char ch = charForCell(grid_[idx(x, y + rowBegin_)]);
+                    std::cout << color_for_char(ch) << ch << RESET;
+                    continue;
+                }
 
-        for (auto const& c : grid_) {
+                TileCounts n;
+                int area = std::min(zoom, cfg_.width - x) * std::min(zoom, height - y);
+                if (level >= 0) {
+                    n = overview_.at(level, x / zoom, y / zoom);
+                }
+                else {
+                    for (int dy = 0; dy < zoom && y + dy < height; ++dy) {
+                        for (int dx = 0; dx < zoom && x + dx < cfg_.width; ++dx) {
+                            auto const& cell = grid_[idx(x + dx, y + dy + rowBegin_)];
+                            if (cell.plant) n.plants++;
+                            if (cell.animal) {
+                                auto& a = *cell.animal;
+                                (a.kind() == AnimalKind::Herbivore ? n.herbivores : n.carnivores)++;
+                                if (a.timers().babyTurns(turn_) > 0) n.babies++;
+                            }
+                        }
+                    }
+                }
+                const char* col;
+                char ch;
+                overviewGlyph(n, area, col, ch);
+                std::cout << col << ch << RESET;
+            }
+            std::cout << '\n';
+        }
+
+        if (zoom > 1) {
+            std::cout << "\nApercu : densite croissante :-=+*#%@ | "
+                << GREEN << "plantes" << RESET << " " << CYAN << "herbivores" << RESET << " "
+                << RED << "carnivores" << RESET << " " << LightRed << "surtout des bebes" << RESET << "\n\n";
+        }
+    }
+
+    TurnMetrics World::metrics() const {
+        TurnMetrics m;
+        m.turn = turn_;
+        m.births = births_;
+        m.deaths = deaths_;
+        m.kills = kills_;
+
+        long long hunger = 0;
+        forEachCell(rowBegin_, rowEnd_, [&](int, int, int i) {
+            auto const& c = grid_[i];
             if (c.plant) {
-                plants++;
+                m.plants++;
             }
             if (c.animal) {
                 auto& a = *c.animal;
-                bool isBaby = (a.baby_turns_ref() > 0);
+                bool isBaby = (a.timers().babyTurns(turn_) > 0);
                 bool isMale = (a.gender() == Gender::Male);
+                hunger += a.timers().hunger(turn_);
 
                 if (a.kind() == AnimalKind::Herbivore) {
-                    herbTotal++;
-                    if (isBaby) {
-                        if (isMale) babyHerbMale++;
-                        else        babyHerbFemale++;
-                    }
+                    int& slot = isBaby ? (isMale ? m.herbBabyMale : m.herbBabyFemale)
+                                       : (isMale ? m.herbMale : m.herbFemale);
+                    slot++;
                 }
                 else {
-                    carnTotal++;
-                    if (isBaby) {
-                        if (isMale) babyCarnMale++;
-                        else        babyCarnFemale++;
-                    }
+                    int& slot = isBaby ? (isMale ? m.carnBabyMale : m.carnBabyFemale)
+                                       : (isMale ? m.carnMale : m.carnFemale);
+                    slot++;
                 }
             }
+        });
+
+        double aggregateHunger = 0.0;
+        if (lod_) {
+            // Les populations agregees sont arrondies et reparties moitie-moitie entre les sexes.
+            double plants = 0.0;
+            std::array<double, 4> n{};
+            for (int t = 0; t < lod_->tileCount(); ++t) {
+                if (lod_->mode(t) != TileMode::Aggregate) continue;
+                auto const& f = lod_->field(t);
+                plants += f.plants;
+                n[0] += f.herbivores.total() - f.herbivores.babies();
+                n[1] += f.herbivores.babies();
+                n[2] += f.carnivores.total() - f.carnivores.babies();
+                n[3] += f.carnivores.babies();
+                aggregateHunger += f.herbivores.meanHunger(cfg_.satiety_after_eat) * f.herbivores.total()
+                    + f.carnivores.meanHunger(cfg_.satiety_after_eat) * f.carnivores.total();
+            }
+            auto split = [](double v, int& male, int& female) {
+                int k = static_cast<int>(std::lround(v));
+                male += (k + 1) / 2;
+                female += k / 2;
+            };
+            m.plants += static_cast<int>(std::lround(plants));
+            split(n[0], m.herbMale, m.herbFemale);
+            split(n[1], m.herbBabyMale, m.herbBabyFemale);
+            split(n[2], m.carnMale, m.carnFemale);
+            split(n[3], m.carnBabyMale, m.carnBabyFemale);
+
+            auto const& ev = lod_->events();
+            m.births += static_cast<int>(std::lround(ev.births));
+            m.deaths += static_cast<int>(std::lround(ev.deaths));
+            m.kills += static_cast<int>(std::lround(ev.kills));
         }
 
-        std::string s = "Turn " + std::to_string(turn) +
-            " | Plants=" + std::to_string(plants) +
-            " Herb=" + std::to_string(herbTotal) +
-            " (baby hm=" + std::to_string(babyHerbMale) +
-            ", hf=" + std::to_string(babyHerbFemale) + ")" +
-            " Carn=" + std::to_string(carnTotal) +
-            " (baby cm=" + std::to_string(babyCarnMale) +
-            ", cf=" + std::to_string(babyCarnFemale) + ")";
+        int animals = m.herbivores() + m.carnivores();
+        if (animals > 0) m.meanHunger = static_cast<float>((hunger + aggregateHunger) / animals);
+        return m;
+    }
+
+    std::string World::statsLine(int turn) const {
+        char buf[kStatsLineMax];
+        return std::string(buf, writeStatsLine(turn, buf, sizeof(buf)));
+    }
 
-        return s;
+    std::size_t World::writeStatsLine(int turn, char* out, std::size_t size) const {
+        TurnMetrics m = metrics();
+
+        char buf[kStatsLineMax];
+        char* p = buf;
+        char* const end = buf + sizeof(buf);
+        auto text = [&](const char* s) { while (*s) *p++ = *s++; };
+        auto num = [&](int v) { p = std::to_chars(p, end, v).ptr; };
+
+        text("Turn "); num(turn);
+        text(" | Plants="); num(m.plants);
+        text(" Herb="); num(m.herbivores());
+        text(" (baby hm="); num(m.herbBabyMale);
+        text(", hf="); num(m.herbBabyFemale); text(")");
+        text(" Carn="); num(m.carnivores());
+        text(" (baby cm="); num(m.carnBabyMale);
+        text(", cf="); num(m.carnBabyFemale); text(")");
+
+        std::size_t n = std::min(static_cast<std::size_t>(p - buf), size);
+        std::memcpy(out, buf, n);
+        return n;
+    }
+
+    World::MemoryReport World::memoryReport() const {
+        MemoryReport r;
+        r.categories = MemoryStats::I().snapshot();
+        for (std::size_t i = 0; i < MemoryStats::kCategories; ++i) {
+            if (static_cast<MemCategory>(i) == MemCategory::Mapped) continue;
+            r.liveBytes += r.categories[i].liveBytes;
+        }
+
+        if (grid_.get_allocator().mapped()) {
+            r.mappedBytes = r.categories[static_cast<std::size_t>(MemCategory::Mapped)].liveBytes;
+            std::int64_t cells = grid_.residentBytes();
+            std::int64_t tables = occupancy_->residentBytes();
+            r.residentMappedBytes = (cells < 0 || tables < 0) ? -1 : cells + tables;
+        }
+
+        auto cells = grid_.size();
+        if (cells > 0) r.bytesPerCell = static_cast<double>(r.liveBytes) / cells;
+
+        r.frameCapacity = frame_.capacity();
+        r.framePeak = frame_.peak();
+        if (cfg_.huge_pages || cfg_.numa_placement) {
+            r.hugePageBytes = Ecosystem::hugePageBytes();
+            r.numaNodes = Topology::I().nodes();
+        }
+        r.allocationsLastTurn = allocationsLastTurn_;
+        if (turn_ > 0) {
+            r.allocationsPerTurn =
+                static_cast<double>(MemoryStats::I().totalAllocations() - allocationsAtStart_) / turn_;
+        }
+        return r;
+    }
+
+    std::string World::memorySummary() const {
+        MemoryReport r = memoryReport();
+        std::ostringstream out;
+        out << "Memoire :\n";
+        for (std::size_t i = 0; i < MemoryStats::kCategories; ++i) {
+            auto const& c = r.categories[i];
+            out << "  " << std::left << std::setw(11) << MemoryStats::name(static_cast<MemCategory>(i))
+                << std::right
+                << " live=" << std::setw(10) << c.liveBytes
+                << " peak=" << std::setw(10) << c.peakBytes
+                << " allocs=" << std::setw(8) << c.allocations
+                << " frees=" << std::setw(8) << c.frees << "\n";
+        }
+        out << "  total live=" << r.liveBytes << " octets"
+            << " | " << std::fixed << std::setprecision(1) << r.bytesPerCell << " octets/cellule"
+            << " | allocs dernier tour=" << r.allocationsLastTurn
+            << " | allocs/tour=" << std::setprecision(1) << r.allocationsPerTurn << "\n";
+        out << "  arene du tour=" << r.frameCapacity << " octets | pic=" << r.framePeak << " octets\n";
+        if (cfg_.huge_pages || cfg_.numa_placement) {
+            out << "  pages enormes=";
+            if (r.hugePageBytes >= 0) out << r.hugePageBytes << " octets";
+            else out << "inconnu";
+            out << " | noeuds NUMA=" << r.numaNodes << "\n";
+        }
+        if (r.mappedBytes > 0) {
+            out << "  projete=" << r.mappedBytes << " octets | en cache=";
+            if (r.residentMappedBytes >= 0) out << r.residentMappedBytes << " octets\n";
+            else out << "inconnu\n";
+        }
+        return out.str();
     }
 
     void World::debugPrintCell(int x, int y) const {
@@ -441,15 +2088,25 @@ namespace Ecosystem {
             std::string genderStr =
                 (a.gender() == Gender::Male ? "Male" : "Female");
 
-            bool isBaby = (a.baby_turns_ref() > 0);
+            const AnimalTimers& t = a.timers();
+            bool isBaby = (t.babyTurns(turn_) > 0);
 
             std::cout << "  Animal : " << kindStr
                 << " | sexe=" << genderStr
                 << " | baby=" << (isBaby ? "oui" : "non")
-                << " | hunger=" << a.hungery_ref()
-                << " | satiety=" << a.satiety_ref()
-                << " | repro_cd=" << a.repro_cooldown_ref()
-                << " | baby_turns=" << a.baby_turns_ref()
+                << " | hunger=" << t.hunger(turn_)
+                << " | satiety=" << t.satiety(turn_)
+                << " | repro_cd=" << t.cooldown(turn_)
+                << " | baby_turns=" << t.babyTurns(turn_)
+                << "\n";
+
+            auto id = [](AnimalHandle h) {
+                return h.valid() ? std::to_string(h.slot) + "." + std::to_string(h.generation) : std::string("-");
+            };
+            const AnimalSlot& s = animalSlots_[t.slot];
+            std::cout << "  Identite : " << id(handleAt(x, y))
+                << " | mere=" << id(s.mother)
+                << " | pere=" << id(s.father)
                 << "\n";
         }
 
@@ -1,49 +1,505 @@
 #pragma once
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <random>
+#include <array>
+#include <chrono>
+#include <memory>
 #include "../core/Config.h"
+#include "../core/MemoryStats.h"
+#include "../core/CounterRandom.h"
+#include "../core/FrameArena.h"
 #include "Cell.h"
+#include "CowPages.h"
+#include "GridLayout.h"
+#include "LevelOfDetail.h"
+#include "OccupancyTable.h"
+#include "OverviewPyramid.h"
+#include "TimerWheel.h"
+#include "MetricsRecorder.h"
 
 namespace Ecosystem {
 
+    class DomainWorker;
+    class HabitatMap;
+
     class World {
     public:
-        explicit World(Config& cfg);
+        explicit World(Config& cfg, GridLayout layout = GridLayout::RowMajor);
+        // Ne stocke que les lignes [rowBegin, rowEnd) de la grille globale ; les
+        // coordonnees restent globales.
+        World(Config& cfg, int rowBegin, int rowEnd, GridLayout layout = GridLayout::RowMajor);
 
         void step();
+        // Tour decoupe : avance le tour courant tranche par tranche (quelques milliers
+        // de cellules ou centaines d'animaux d'un systeme, lot de tuiles LOD, de
+        // deplacements, de sources de propagation ou de reveils) jusqu'a deadline, une tranche au moins, et renvoie true a la fin du tour.
+        // Les tranches suivent l'ordre de step() : meme resultat. Entre deux appels
+        // le monde est en cours de tour ; on peut l'afficher, pas l'embrancher.
+        // step() termine un tour commence ainsi.
+        bool stepUntil(std::chrono::steady_clock::time_point deadline);
+        bool stepFor(std::chrono::microseconds budget) {
+            return stepUntil(std::chrono::steady_clock::now() + budget);
+        }
+        bool inTurn() const { return cursor_.phase != StepPhase::Idle; }
         void print(int debugX = -1, int debugY = -1) const;
+
+        // Fenetre d'affichage : columns x rows caracteres a partir de la cellule (x, y),
+        // chaque caractere couvrant zoom x zoom cellules (arrondi a une puissance de 2).
+        struct View {
+            int x = 0;
+            int y = 0;
+            int columns = 100;
+            int rows = 35;
+            int zoom = 1;
+        };
+        // Cellules brutes a zoom 1, sinon apercu en densites tire de la pyramide :
+        // le cout suit la taille de la vue, pas celle du monde.
+        void printView(View view) const;
+        const OverviewPyramid& overview() const { return overview_; }
         std::string statsLine(int turn) const;
+        // Meme texte dans out, sans allocation ; renvoie sa longueur (tronque a size).
+        static constexpr std::size_t kStatsLineMax = 192;
+        std::size_t writeStatsLine(int turn, char* out, std::size_t size) const;
+        // Recensement du dernier tour et compteurs d'evenements (naissances, morts, predations).
+        TurnMetrics metrics() const;
         std::string serialize(int turn) const;
 
         void debugPrintCell(int x, int y) const;
 
+        // Identite d'un animal : son emplacement dans la table des animaux, qui le suit
+        // a chaque deplacement, et la generation de cet emplacement, qui change a sa
+        // mort. Une poignee perimee ne designe donc jamais un autre animal. Les
+        // embranchements partent de la meme table ; un animal absorbe par une tuile
+        // agregee (ou recu d'un autre domaine) revient avec une nouvelle identite.
+        struct AnimalHandle {
+            std::int32_t slot = -1;
+            std::uint32_t generation = 0;
+            bool valid() const { return slot >= 0; }
+            bool operator==(const AnimalHandle&) const = default;
+        };
+        // Poignee de l'animal en (x, y), invalide si la cellule n'en a pas.
+        AnimalHandle handleAt(int x, int y) const;
+        // Animal vivant designe par h et sa position, en O(1) ; nullptr s'il est mort.
+        const IAnimal* find(AnimalHandle h, int* x = nullptr, int* y = nullptr) const;
+
+        // Releve d'un individu suivi. Les parents sont ceux de la naissance (invalides
+        // pour la population initiale) ; ils ne sont plus connus apres la mort.
+        struct AnimalRecord {
+            AnimalHandle handle;
+            bool alive = false;
+            int x = -1;
+            int y = -1;
+            int hunger = 0;
+            int satiety = 0;
+            bool baby = false;
+            AnimalHandle mother;
+            AnimalHandle father;
+        };
+        AnimalRecord record(AnimalHandle h) const;
+        // Un releve par poignee, dans l'ordre : le cout suit le nombre d'individus suivis.
+        void records(const std::vector<AnimalHandle>& handles, std::vector<AnimalRecord>& out) const;
+
+        // Embranchement au tour courant : un monde independant qui partage avec celui-ci
+        // les pages de cellules non modifiees (copie sur ecriture, voir CowPages.h) ;
+        // le cout est celui des pages ecrites ensuite par l'un ou l'autre. cfg doit avoir
+        // les memes dimensions ; ses regles et sa graine (donc ses tirages) peuvent differer.
+        // Leve std::logic_error en cours de tour decoupe.
+        std::unique_ptr<World> fork() const;
+        std::unique_ptr<World> fork(Config& cfg) const;
+        // Pages de cellules encore partagees avec un autre monde, sur le total.
+        std::pair<std::size_t, std::size_t> sharedPages() const { return { grid_.sharedPages(), grid_.pageCount() }; }
+
+        // Simulation hybride (monde complet seulement) : les tuiles calmes hors de la
+        // region d'interet passent au modele agrege et reviennent en detail quand
+        // elles y entrent ou deviennent heterogenes. Le hash d'etat ne couvre que
+        // les cellules simulees en detail ; metrics() inclut les populations agregees.
+        void enableLevelOfDetail(const LodOptions& opt);
+        void setRegionOfInterest(int x0, int y0, int x1, int y1);
+        const LevelOfDetail* levelOfDetail() const { return lod_.get(); }
+
         Cell* getCell(int x, int y);
         const Cell* getCell(int x, int y) const;
+        // Case infranchissable de la carte d'habitat : ni plante ni animal n'y entre.
+        bool isBlocked(int x, int y) const { return inBounds(x, y) && isBlocked(idx(x, y)); }
+        // visit(cell, nx, ny) pour les cellules de [x - r, x + r] x [y - r, y + r],
+        // ligne par ligne. En disposition Padded (r <= PaddedGrid::kMargin) la fenetre
+        // est lue par decalages, bordure comprise : visit doit ignorer les cellules vides.
+        template <class Visit> void forEachInWindow(int x, int y, int radius, Visit&& visit) const;
+        // Idem pour les quatre voisines (droite, gauche, bas, haut) ; s'arrete des que
+        // visit renvoie true, et le renvoie.
+        template <class Visit> bool forEachNeighbor(int x, int y, Visit&& visit) const;
         const Config& cfg() const { return cfg_; }
+        int turn() const { return turn_; }
+        int rowBegin() const { return rowBegin_; }
+        int rowEnd() const { return rowEnd_; }
+        GridLayout layout() const { return layout_; }
+
+        // Tirage du tour courant propre a la cellule (x, y) ; voir CounterRandom.h.
+        int randomInt(RandomStream stream, int x, int y, int n) const {
+            return counterRandomInt(cfg_.seed, static_cast<std::uint64_t>(turn_), stream,
+                static_cast<std::uint64_t>(y) * cfg_.width + x, n);
+        }
+
+        struct RegionCounts {
+            int plants = 0;
+            int herbivores = 0;
+            int carnivores = 0;
+        };
+
+        // Populations d'un rectangle [x0,x1]x[y0,y1], etat du debut de tour.
+        RegionCounts regionCounts(int x0, int y0, int x1, int y1) const;
+        int countInRadius(OccupancyLayer layer, int x, int y, int radius) const;
+        const OccupancyTable& occupancy() const { return *occupancy_; }
+
+        struct MemoryReport {
+            MemoryStats::Snapshot categories{};
+            std::int64_t liveBytes = 0;
+            double bytesPerCell = 0.0;
+            std::int64_t allocationsLastTurn = 0;
+            double allocationsPerTurn = 0.0;
+            // Tables projetees depuis le disque (Config::mapped_storage_dir) et leur part
+            // dans le cache de pages du systeme.
+            std::int64_t mappedBytes = 0;
+            std::int64_t residentMappedBytes = 0;
+            std::size_t frameCapacity = 0;
+            std::size_t framePeak = 0;
+            // Config::huge_pages / numa_placement : octets du processus sur pages
+            // enormes (-1 si inconnu) et noeuds NUMA vus.
+            std::int64_t hugePageBytes = 0;
+            int numaNodes = 1;
+        };
+
+        MemoryReport memoryReport() const;
+        // Arene des donnees du tour (deplacements decides, sources de propagation,
+        // texte rendu...), rembobinee a la fin de chaque step().
+        const FrameArena& frameArena() const { return frame_; }
+        std::string memorySummary() const;
+
+        // Mutations utilisees par les strategies ; elles maintiennent le hash d'etat.
+        void eatPlant(int x, int y);
+        void killAnimal(int x, int y);
+        void feedAnimal(int x, int y);
+
+        // Hash 64 bits de l'etat complet, tenu a jour a chaque mutation.
+        std::uint64_t stateHash() const { return hash_; }
+        std::uint64_t recomputeStateHash() const;
+        bool verifyStateHash() const { return recomputeStateHash() == hash_; }
+        // Compare la pyramide d'apercu tenue a jour avec un recomptage complet.
+        bool verifyOverview() const;
+        // Hash des seules lignes [y0, y1) ; le XOR de bandes disjointes donne le hash global.
+        std::uint64_t hashRows(int y0, int y1) const;
 
     private:
+        friend class DomainWorker;
+
+        struct Move { int x, y, nx, ny; };
+
+        World(const World& parent, Config& cfg);
+
         Config& cfg_;
-        std::vector<Cell> grid_;
+        int rowBegin_ = 0;
+        int rowEnd_ = 0;
+        GridLayout layout_;
+        int blocksPerRow_ = 0;
+        // Pages de 2 Mo, une page enorme chacune avec Config::huge_pages.
+        CowPages<Cell, MemCategory::Grid, hugePageBits<Cell>()> grid_;
+        // Disposition Padded : longueur d'une ligne stockee, bordure comprise ; decalages
+        // des fenetres de rayon 0 a kMargin (a la suite, ligne par ligne) et des voisines.
+        struct NeighborOffset {
+            int offset;
+            std::int8_t dx, dy;
+        };
+        int padStride_ = 0;
+        std::vector<NeighborOffset, TrackingAllocator<NeighborOffset, MemCategory::Grid>> windowOffsets_;
+        std::array<int, PaddedGrid::kMargin + 2> windowStart_{};
+        std::array<int, 4> neighborOffsets_{};
+        void buildOffsets();
         int turn_ = 0;
+        std::int64_t allocationsAtStart_ = 0;
+        std::int64_t allocationsLastTurn_ = 0;
+        std::uint64_t hash_ = 0;
+
+        int births_ = 0;
+        int deaths_ = 0;
+        int kills_ = 0;
+        // Reconstruite a chaque tour : partagee avec les embranchements jusqu'a la
+        // reconstruction suivante, qui en alloue alors une neuve.
+        std::shared_ptr<OccupancyTable> occupancy_;
+
+        // Donnees du tour : dans frame_, vides entre deux tours (voir endFrame).
+        FrameArena frame_;
+        FrameVector<Move> moves_{ &frame_ };
+        FrameVector<std::pair<int, int>> spreadSources_{ &frame_ };
+        FrameVector<int> lodCells_{ &frame_ };
+        void endFrame();
+
+        // Plantes ayant au moins une voisine vide (seules sources possibles de
+        // propagation), un bit par cellule dans l'ordre de la grille.
+        CowPages<std::uint64_t, MemCategory::Grid> frontier_;
+        int plantCount_ = 0;
+        // Cases infranchissables, un bit par cellule ; vide sans carte qui en a.
+        CowPages<std::uint64_t, MemCategory::Grid> blocked_;
+        bool isBlocked(int i) const {
+            return blocked_.size() != 0 && ((blocked_[i >> 6] >> (i & 63)) & 1) != 0;
+        }
 
-        int idx(int x, int y) const { return y * cfg_.width + x; }
+        // Table des animaux : identites (AnimalHandle) et reveils (voir TimerWheel.h).
+        // L'emplacement d'un animal suit sa cellule ; il change de generation quand
+        // l'animal disparait, ce qui annule ses poignees et ses reveils encore programmes.
+        struct AnimalSlot {
+            std::int32_t cell;
+            std::uint32_t generation;
+            AnimalHandle mother;
+            AnimalHandle father;
+        };
+        TimerWheel timers_;
+        std::vector<AnimalSlot, TrackingAllocator<AnimalSlot, MemCategory::Animals>> animalSlots_;
+        std::vector<std::int32_t, TrackingAllocator<std::int32_t, MemCategory::Animals>> freeAnimalSlots_;
+        // Emplacements liberes pendant deplacements, nourrissage et reproduction, rendus
+        // a freeAnimalSlots_ apres la reproduction : les naissances du tour prennent les
+        // emplacements libres du debut de tour, quel que soit l'ordre des bandes (sysFused).
+        std::vector<std::int32_t, TrackingAllocator<std::int32_t, MemCategory::Animals>> heldSlots_;
+        bool holdSlots_ = false;
+        void holdReleasedSlots(bool hold);
+        // Ensembles prets, un bit par cellule comme frontier_ : adultes (deplacements)
+        // et animaux sans repos en cours (reproduction).
+        CowPages<std::uint64_t, MemCategory::Grid> mobile_;
+        CowPages<std::uint64_t, MemCategory::Grid> ready_;
+
+        std::unique_ptr<LevelOfDetail> lod_;
+        // Densites plantes / herbivores / carnivores par tuile au debut du tour.
+        std::vector<std::array<double, 3>, TrackingAllocator<std::array<double, 3>, MemCategory::Scratch>> lodDensity_;
+
+        OverviewPyramid overview_;
+        void rebuildOverview(OverviewPyramid& out) const;
+        bool sameOverview(const OverviewPyramid& fresh) const;
+        // Position de la cellule i pour la pyramide (ligne relative au stockage).
+        std::pair<int, int> localPosition(int i) const {
+            int x, y;
+            positionOf(i, x, y);
+            return { x, y - rowBegin_ };
+        }
+
+        int idx(int x, int y) const {
+            int ly = y - rowBegin_;
+            if (layout_ == GridLayout::RowMajor) return ly * cfg_.width + x;
+            if (layout_ == GridLayout::Padded) return (ly + PaddedGrid::kMargin) * padStride_ + x + PaddedGrid::kMargin;
+            int block = (ly >> TiledGrid::kBlockBits) * blocksPerRow_ + (x >> TiledGrid::kBlockBits);
+            return block * TiledGrid::kBlockCells + TiledGrid::offset(x, ly);
+        }
+        // Inverse de idx.
+        void positionOf(int i, int& x, int& y) const;
+        // Indices de stockage couvrant les lignes [y0, y1), cellules hors lignes comprises.
+        std::pair<int, int> storageSpan(int y0, int y1) const;
+        // fn(x, y, i) pour chaque cellule des lignes [y0, y1), dans l'ordre de la disposition.
+        template <class Fn> void forEachCell(int y0, int y1, Fn&& fn) const;
+        // Idem pour les seules cellules dont le bit est leve. Les bits sont relus au fil
+        // du parcours : ceux que fn leve plus loin sont vus, ceux qu'elle baisse non.
+        template <class Fn> void forEachSet(const CowPages<std::uint64_t, MemCategory::Grid>& bits,
+            int y0, int y1, Fn&& fn) const;
+        // Idem sur tout le stockage a partir de l'index from, pour au plus limit bits ;
+        // renvoie l'index ou reprendre (storageEnd() a la fin).
+        template <class Fn> int forEachSetFrom(const CowPages<std::uint64_t, MemCategory::Grid>& bits,
+            int from, int limit, Fn&& fn) const;
+        // fn(x, y, i) pour les cellules des indices de stockage [first, last).
+        template <class Fn> void forEachStored(int first, int last, Fn&& fn) const;
+        int storageEnd() const { return storageSpan(rowBegin_, rowEnd_).second; }
+        // Bits leves dans les mots couvrant ces lignes : de quoi reserver sans deborder.
+        int countSet(const CowPages<std::uint64_t, MemCategory::Grid>& bits, int y0, int y1) const;
+
+        // Stockage projete : les parcours avancent par bandes de streamRows_ lignes ;
+        // on precharge la bande suivante et on rend celles qui sont hors de portee
+        // (la bande precedente reste, elle couvre le rayon de recherche des strategies).
+        int streamRows_ = 0;
+        mutable int streamBand_ = -1;
+        void streamRow(int y) const;
+        void adviseBand(int band, Residency r) const;
         bool inBounds(int x, int y) const {
-            return x >= 0 && x < cfg_.width && y >= 0 && y < cfg_.height;
+            return x >= 0 && x < cfg_.width && y >= rowBegin_ && y < rowEnd_;
         }
 
-        void seedPlants(int n);
-        void seedHerbivores(int n);
-        void seedCarnivores(int n);
+        // Config::numa_placement : pages des cellules et des tables d'occupation
+        // allouees sur le noeud de leurs lignes, avant tout autre acces.
+        void placeOnNodes();
+        void seedPlants(int n, std::mt19937& rng);
+        void seedAnimals(int nHerbs, int nCarns, std::mt19937& rng);
+        void seedHabitat(const HabitatMap& map);
+
+        // Position d'un tour decoupe : phase en cours, prochaine ligne (bandes) ou
+        // prochain element (deplacements, sources de propagation) a traiter.
+        // Les parcours de cellules reprennent a un index de stockage (item) : l'ordre
+        // reste celui du parcours complet quelle que soit la disposition. Les phases
+        // LodAbsorb a LodEmit se suivent dans cet ordre.
+        enum class StepPhase : std::uint8_t {
+            Idle, LodAbsorb, LodDensity, LodModes, LodModel, LodEmit, LodOccupancy,
+            Decide, Apply, Feed, Reproduce, Collect, Spread, Aging, Occupancy, Verify
+        };
+        struct StepCursor {
+            StepPhase phase = StepPhase::Idle;
+            int row = 0;
+            std::size_t item = 0;
+            int plants = 0;
+            double plantBudget = 0.0;
+            std::uint64_t hash = 0; // avant LOD, puis hash recalcule (Verify)
+            std::int64_t allocsBefore = 0;
+        };
+        StepCursor cursor_;
+        // Travail d'une tranche : cellules parcourues, animaux qui decident ou se
+        // reproduisent (une fenetre de recherche chacun), elements des listes.
+        static constexpr int kSliceCells = 4096;
+        static constexpr int kSliceAnimals = 128;
+        static constexpr std::size_t kSliceItems = 1024;
+        OverviewPyramid verifyScratch_;
+        void beginTurn();
+        void endTurn();
+        void finishTurn();
+        // Config::verify_state_hash : compare a un recalcul et corrige en cas d'ecart.
+        void checkRecomputed(std::uint64_t hash, const OverviewPyramid& fresh);
+        void enterPhase(StepPhase phase);
+        // Une tranche ; true quand le tour est termine.
+        bool stepSlice();
 
         void sysMove();
         void sysFeed();
         void sysReproduce();
         void sysPlantsSpread();
         void sysAgingAndStarvation();
+        void rebuildOccupancy();
+        void beginOccupancy();
+        void occupancyRows(int y0, int y1);
+        void sysLevelOfDetail();
+        // Une etape LOD (LodAbsorb a LodEmit) pour les tuiles [t0, t1).
+        void levelOfDetailTiles(StepPhase stage, int t0, int t1, double& plantBudget);
+        double lodPlantBudget() const;
+
+        // Config::fused_step : deplacements, nourrissage et reproduction en front d'onde
+        // sur des bandes de lignes. Chaque systeme suit le precedent d'assez de bandes
+        // pour que ses lectures et ecritures ne touchent que des lignes deja finies par
+        // le precedent et pas encore lues par lui : meme etat que les trois parcours
+        // complets, les bandes en vol restant dans le cache.
+        void sysFused();
+        int fusedRows() const;
+        // Bandes d'avance pour un systeme qui lit ou ecrit a reach lignes de la bande
+        // d'un systeme precedent (portee de lecture de l'un + portee d'ecriture de l'autre).
+        static int fusedLag(int reach, int rows) { return 1 + (reach + rows - 1) / rows; }
+        // Taille visee des bandes en vol d'un tour fusionne : la moitie d'un cache L2
+        // courant. Une cellule compte pour elle-meme et pour la part moyenne des plantes
+        // et animaux qu'elle designe (objets sur le tas, ~4 sizeof(Cell) aux densites
+        // par defaut) : compter sizeof(Cell) seul donnait des bandes trop larges.
+        static constexpr std::size_t kFusedBytes = std::size_t(1) << 20;
+        static constexpr std::size_t kFusedCellBytes = 4 * sizeof(Cell);
+
+        // Les systemes decoupes en phases sur des bandes de lignes, dans l'ordre de step().
+        void decideMoves(int y0, int y1);
+        void applyMoves();
+        void applyMoves(std::size_t first, std::size_t last);
+        void feedRows(int y0, int y1);
+        void reproduceRows(int y0, int y1);
+        void decideMove(int x, int y, int i);
+        void feedCell(int x, int y, int i);
+        void reproduceCell(int x, int y, int i);
+        bool isSpreadTurn() const;
+        int countPlants(int y0, int y1) const;
+        void collectSpreadSources(int y0, int y1);
+        // Sources des indices de stockage [first, last), ajoutees a la suite.
+        void appendSpreadSources(int first, int last, int y0, int y1);
+        int spreadPlants(int plantCount);
+        // Sources [first, last) seulement, a enchainer dans l'ordre.
+        int spreadPlants(int plantCount, std::size_t first, std::size_t last);
+        // Reveils du tour courant pour les animaux des lignes [y0, y1) ; ceux des
+        // autres lignes sont abandonnes (halos, reecrits a chaque echange).
+        void fireTimers(int y0, int y1);
+        void fireTimer(const TimerEntry& e, int y0, int y1);
+
+        // Etat complet de lignes, pour les echanges de halo entre domaines.
+        void encodeRows(int y0, int y1, std::vector<std::uint8_t>& out) const;
+        void decodeRows(const std::uint8_t* data, std::size_t size);
+
+        // Index logique global (y * largeur + x), independant de la disposition.
+        std::uint64_t cellKey(int i) const {
+            if (layout_ == GridLayout::RowMajor) {
+                return static_cast<std::uint64_t>(i) + static_cast<std::uint64_t>(rowBegin_) * cfg_.width;
+            }
+            int x, y;
+            positionOf(i, x, y);
+            return static_cast<std::uint64_t>(y) * cfg_.width + x;
+        }
+        bool isEmptyCell(int x, int y) const {
+            return inBounds(x, y) && !grid_[idx(x, y)].plant && !grid_[idx(x, y)].animal && !isBlocked(idx(x, y));
+        }
+        void rebuildFrontier();
+        void rebuildTimers();
+        // L'animal pose en i prend un emplacement, entre dans les ensembles prets et
+        // programme ses reveils ; ses echeances sont nulles ou apres le tour courant.
+        void adoptAnimal(int i);
+        // Avant de retirer l'animal de la cellule i.
+        void releaseAnimal(int i);
+        void schedule(std::int32_t slot, TimerKind kind, int due);
+        int starvationTurn(const AnimalTimers& t) const {
+            return std::max(t.hungryAt + cfg_.starvation_limit, turn_ + 1);
+        }
+        void updateFrontierBit(int x, int y);
+        // A appeler quand la cellule i change de contenu : elle et ses voisines.
+        void touchFrontier(int i);
+
+        // Niveau de detail : densites d'une tuile, passage d'un mode a l'autre,
+        // individus qui traversent la frontiere entre les deux.
+        std::array<double, 3> tileDensity(int t) const;
+        bool tileHeterogeneous(int t, double threshold) const;
+        void absorbTile(int t);
+        void aggregateTile(int t);
+        void materializeTile(int t);
+        void emitMigrants(int t, double& plantBudget);
+        int aggregatePlants() const;
+
+        void moveAnimal(int from, int to);
+        void spawnAnimal(int i, std::unique_ptr<IAnimal> a);
+        // Pose sans compter de naissance, retire sans compter de mort.
+        void placeAnimal(int i, std::unique_ptr<IAnimal> a);
+        void clearCell(int i);
+        void spawnPlant(int i);
+        void setReproCooldown(int i, int value);
 
         char charForCell(const Cell& c) const;
 
         const char* color_for_char(char ch) const;
     };
 
+    template <class Visit>
+    void World::forEachInWindow(int x, int y, int radius, Visit&& visit) const {
+        if (layout_ == GridLayout::Padded && radius <= PaddedGrid::kMargin && inBounds(x, y)) {
+            const int center = idx(x, y);
+            for (int k = windowStart_[radius]; k < windowStart_[radius + 1]; ++k) {
+                auto const& o = windowOffsets_[k];
+                visit(grid_[center + o.offset], x + o.dx, y + o.dy);
+            }
+            return;
+        }
+        for (int dy = -radius; dy <= radius; ++dy) {
+            for (int dx = -radius; dx <= radius; ++dx) {
+                int nx = x + dx, ny = y + dy;
+                if (inBounds(nx, ny)) visit(grid_[idx(nx, ny)], nx, ny);
+            }
+        }
+    }
+
+    template <class Visit>
+    bool World::forEachNeighbor(int x, int y, Visit&& visit) const {
+        static constexpr std::array<std::pair<int, int>, 4> kDirs{ { {1, 0}, {-1, 0}, {0, 1}, {0, -1} } };
+        if (layout_ == GridLayout::Padded && inBounds(x, y)) {
+            const int center = idx(x, y);
+            for (int d = 0; d < 4; ++d) {
+                if (visit(grid_[center + neighborOffsets_[d]], x + kDirs[d].first, y + kDirs[d].second)) return true;
+            }
+            return false;
+        }
+        for (auto [dx, dy] : kDirs) {
+            int nx = x + dx, ny = y + dy;
+            if (inBounds(nx, ny) && visit(grid_[idx(nx, ny)], nx, ny)) return true;
+        }
+        return false;
+    }
+
 }
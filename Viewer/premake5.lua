@@ -0,0 +1,42 @@
+project "EcosystemViewer"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+    staticruntime "on"
+
+    targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+    objdir    ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+    -- Le visualiseur ne partage avec la simulation que le format des trames
+    files {
+        "src/**.h",
+        "src/**.cpp",
+        "%{wks.location}/Ecosystem/src/live/FrameRing.h",
+        "%{wks.location}/Ecosystem/src/live/SharedMemory.h",
+        "%{wks.location}/Ecosystem/src/live/SharedMemory.cpp"
+    }
+
+    includedirs {
+        "src",
+        "%{IncludeDir.Ecosystem}"
+    }
+
+    defines {
+        "_CRT_SECURE_NO_WARNINGS"
+    }
+
+    filter "system:windows"
+        systemversion "latest"
+
+    filter "system:linux"
+        links { "rt" }
+
+    filter "configurations:Debug"
+        defines { "DEBUG", "_DEBUG" }
+        runtime "Debug"
+        symbols "on"
+
+    filter "configurations:Release"
+        defines { "RELEASE", "NDEBUG" }
+        runtime "Release"
+        optimize "on"
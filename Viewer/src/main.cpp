@@ -0,0 +1,305 @@
+#include "live/FrameRing.h"
+#include "live/SharedMemory.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <conio.h>
+#else
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+// Visualiseur d'une simulation en cours : s'attache au segment publie par
+// `Ecosystem --live [nom]`, se detache quand la simulation s'arrete et
+// attend la suivante. Ne fait que lire : la simulation ne l'attend jamais.
+//
+// Touches : fleches ou wasd (z aussi pour monter) pour se deplacer, + et - pour le zoom,
+// f pour voir tout le monde, q pour quitter.
+
+using namespace Ecosystem;
+
+namespace {
+
+    volatile std::sig_atomic_t g_quit = 0;
+
+    void onSignal(int) { g_quit = 1; }
+
+    enum class Key { None, Up, Down, Left, Right, ZoomIn, ZoomOut, Fit, Quit };
+
+#ifdef _WIN32
+
+    struct RawTerminal {};
+
+    Key readKey() {
+        if (!_kbhit()) return Key::None;
+        int c = _getch();
+        if (c == 0 || c == 224) {
+            switch (_getch()) {
+            case 72: return Key::Up;
+            case 80: return Key::Down;
+            case 75: return Key::Left;
+            case 77: return Key::Right;
+            default: return Key::None;
+            }
+        }
+        switch (c) {
+        case 'z': case 'w': return Key::Up;
+        case 's': return Key::Down;
+        case 'q': return Key::Quit;
+        case 'a': return Key::Left;
+        case 'd': return Key::Right;
+        case '+': case '=': return Key::ZoomIn;
+        case '-': return Key::ZoomOut;
+        case 'f': return Key::Fit;
+        case 27: return Key::Quit;
+        default: return Key::None;
+        }
+    }
+
+#else
+
+    // Terminal sans echo ni tampon de ligne, lectures non bloquantes.
+    struct RawTerminal {
+        termios saved{};
+        bool active = false;
+
+        RawTerminal() {
+            if (tcgetattr(STDIN_FILENO, &saved) != 0) return;
+            termios raw = saved;
+            raw.c_lflag &= ~(ICANON | ECHO);
+            raw.c_cc[VMIN] = 0;
+            raw.c_cc[VTIME] = 0;
+            active = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+        }
+        ~RawTerminal() {
+            if (active) tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+        }
+    };
+
+    Key readKey() {
+        char c = 0;
+        if (::read(STDIN_FILENO, &c, 1) != 1) return Key::None;
+        if (c == 27) {
+            char seq[2] = {};
+            if (::read(STDIN_FILENO, &seq[0], 1) != 1) return Key::Quit;
+            if (::read(STDIN_FILENO, &seq[1], 1) != 1) return Key::None;
+            switch (seq[1]) {
+            case 'A': return Key::Up;
+            case 'B': return Key::Down;
+            case 'C': return Key::Right;
+            case 'D': return Key::Left;
+            default: return Key::None;
+            }
+        }
+        switch (c) {
+        case 'z': case 'w': return Key::Up;
+        case 's': return Key::Down;
+        case 'a': return Key::Left;
+        case 'd': return Key::Right;
+        case '+': case '=': return Key::ZoomIn;
+        case '-': return Key::ZoomOut;
+        case 'f': return Key::Fit;
+        case 'q': return Key::Quit;
+        default: return Key::None;
+        }
+    }
+
+#endif
+
+    // Memes couleurs que World::print, dans l'ordre de CellCode.
+    const char* const kCellColors[] = {
+        "\033[0m",  // vide
+        "\033[32m", // plante
+        "\033[36m", "\033[34m", "\033[91m", "\033[90m",
+        "\033[31m", "\033[35m", "\033[91m", "\033[37m"
+    };
+
+    // Quand une case d'ecran couvre plusieurs cellules, on montre la plus visible.
+    int priority(CellCode c) {
+        switch (c) {
+        case CellCode::Empty: return 0;
+        case CellCode::Plant: return 1;
+        case CellCode::HerbBabyMale: case CellCode::HerbBabyFemale: return 2;
+        case CellCode::HerbMale: case CellCode::HerbFemale: return 3;
+        case CellCode::CarnBabyMale: case CellCode::CarnBabyFemale: return 4;
+        default: return 5;
+        }
+    }
+
+    struct Viewport {
+        int x = 0;
+        int y = 0;
+        int zoom = 1; // cellules par caractere, en largeur comme en hauteur
+        int columns = 100;
+        int rows = 35;
+
+        void clamp(int width, int height) {
+            zoom = std::clamp(zoom, 1, std::max(width, height));
+            x = std::clamp(x, 0, std::max(0, width - columns * zoom));
+            y = std::clamp(y, 0, std::max(0, height - rows * zoom));
+        }
+
+        void fit(int width, int height) {
+            zoom = std::max((width + columns - 1) / columns, (height + rows - 1) / rows);
+            x = y = 0;
+        }
+    };
+
+    void render(const FrameRing::Header& h, const FrameStats& stats, const std::vector<std::uint8_t>& cells,
+        std::uint64_t frame, std::uint64_t skipped, const Viewport& view) {
+        std::string out;
+        out.reserve(static_cast<std::size_t>(view.columns + 16) * view.rows * 6);
+        out += "\033[H";
+
+        out += "Turn " + std::to_string(stats.turn)
+            + " | Plants=" + std::to_string(stats.plants)
+            + " Herb=" + std::to_string(stats.herbivores)
+            + " Carn=" + std::to_string(stats.carnivores)
+            + " (bebes " + std::to_string(stats.babies) + ")"
+            + " | trame " + std::to_string(frame)
+            + " (sautees " + std::to_string(skipped) + ")"
+            + " | " + std::to_string(h.width) + "x" + std::to_string(h.height)
+            + " zoom 1/" + std::to_string(view.zoom)
+            + " @ " + std::to_string(view.x) + "," + std::to_string(view.y)
+            + "\033[K\n";
+
+        for (int r = 0; r < view.rows; ++r) {
+            int y0 = view.y + r * view.zoom;
+            if (y0 >= h.height) {
+                out += "\033[K\n";
+                continue;
+            }
+            for (int c = 0; c < view.columns; ++c) {
+                int x0 = view.x + c * view.zoom;
+                if (x0 >= h.width) break;
+
+                CellCode best = CellCode::Empty;
+                for (int y = y0; y < std::min(y0 + view.zoom, static_cast<int>(h.height)); ++y) {
+                    for (int x = x0; x < std::min(x0 + view.zoom, static_cast<int>(h.width)); ++x) {
+                        CellCode code = packedCode(cells.data(), static_cast<std::size_t>(y) * h.width + x);
+                        if (priority(code) > priority(best)) best = code;
+                    }
+                }
+                auto k = static_cast<int>(best);
+                if (k >= static_cast<int>(CellCode::Count)) k = 0;
+                out += kCellColors[k];
+                out += kCellCodeChars[k];
+            }
+            out += "\033[0m\033[K\n";
+        }
+        out += "\033[J";
+        std::cout << out << std::flush;
+    }
+
+    int parseInt(const char* s, int fallback) {
+        int v = std::atoi(s);
+        return v > 0 ? v : fallback;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string name = "ecosystem";
+    int fps = 10;
+    Viewport view;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--fps" && i + 1 < argc) fps = parseInt(argv[++i], fps);
+        else if (arg == "--cols" && i + 1 < argc) view.columns = parseInt(argv[++i], view.columns);
+        else if (arg == "--rows" && i + 1 < argc) view.rows = parseInt(argv[++i], view.rows);
+        else if (arg[0] != '-') name = arg;
+    }
+
+    std::signal(SIGINT, onSignal);
+    RawTerminal terminal;
+    auto period = std::chrono::milliseconds(1000 / fps);
+
+    Ecosystem::SharedMemoryRegion region;
+    std::vector<std::uint8_t> cells;
+    FrameStats stats;
+    std::uint64_t shown = 0;
+    std::uint64_t skipped = 0;
+    bool hasFrame = false;
+    bool waiting = false;
+
+    std::cout << "\033[2J";
+
+    while (!g_quit) {
+        auto next = std::chrono::steady_clock::now() + period;
+
+        if (!region.isOpen()) {
+            if (region.open(name) && FrameRing(region.data()).valid(region.size())) {
+                const auto& h = FrameRing(region.data()).header();
+                cells.assign(FrameRing::packedBytes(h.width, h.height), 0);
+                view.clamp(h.width, h.height);
+                hasFrame = false;
+                waiting = false;
+                skipped = 0;
+                std::cout << "\033[2J";
+            }
+            else {
+                region.close();
+                if (!waiting) {
+                    std::cout << "\033[H\033[J En attente de la simulation \"" << name << "\" ...\n" << std::flush;
+                    waiting = true;
+                }
+            }
+        }
+
+        bool dirty = false;
+        for (Key k = readKey(); k != Key::None; k = readKey()) {
+            int step = std::max(1, view.columns / 4) * view.zoom;
+            switch (k) {
+            case Key::Up: view.y -= step / 2; break;
+            case Key::Down: view.y += step / 2; break;
+            case Key::Left: view.x -= step; break;
+            case Key::Right: view.x += step; break;
+            case Key::ZoomIn: view.zoom /= 2; break;
+            case Key::ZoomOut: view.zoom *= 2; break;
+            case Key::Fit:
+                if (region.isOpen()) {
+                    const auto& h = FrameRing(region.data()).header();
+                    view.fit(h.width, h.height);
+                }
+                break;
+            case Key::Quit: g_quit = 1; break;
+            default: break;
+            }
+            dirty = true;
+        }
+
+        if (region.isOpen()) {
+            FrameRing ring(region.data());
+            const auto& h = ring.header();
+            view.clamp(h.width, h.height);
+
+            ring.touchReader();
+            std::uint64_t frame = 0;
+            if (ring.readLatest(stats, cells.data(), frame) && (!hasFrame || frame != shown)) {
+                if (hasFrame && frame > shown + 1) skipped += frame - shown - 1;
+                shown = frame;
+                hasFrame = true;
+                dirty = true;
+            }
+            if (hasFrame && dirty) render(h, stats, cells, shown, skipped, view);
+
+            if (h.closed.load(std::memory_order_acquire)) {
+                region.close();
+                std::cout << "\n Simulation terminee, detache.\n" << std::flush;
+                waiting = true;
+            }
+        }
+
+        std::this_thread::sleep_until(next);
+    }
+
+    std::cout << "\033[0m\n";
+    return 0;
+}
@@ -25,5 +25,6 @@ group ""
 
 group "Ecosystem"
 	include "Ecosystem"
+	include "Viewer"
 group ""
 